@@ -0,0 +1,360 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <future>
+#include <stdexcept>
+#include <vector>
+//
+#include <lyrahgames/robin_hood/meta.hpp>
+//
+#include <lyrahgames/robin_hood/flat_map.hpp>
+#include <lyrahgames/robin_hood/flat_set.hpp>
+#include <lyrahgames/robin_hood/detail/raise.hpp>
+
+namespace lyrahgames::robin_hood {
+
+/// \class background_flat_map background_flat_map.hpp
+/// A flat map whose inserting thread never has to stop for a full rehash.
+/// As soon as the load factor crosses the soft load factor, the current table
+/// is frozen and a table with twice its capacity is built from it on a
+/// background worker. All writes issued in the meantime are logged in a small
+/// separate table and replayed when the new table is swapped in. The old
+/// table is destroyed on a background worker as well.
+/// Values have to be copyable because the frozen table is read concurrently.
+template <generic::key                       Key,
+          generic::value                     Value,
+          generic::hasher<Key>               Hasher    = std::hash<Key>,
+          generic::equivalence_relation<Key> Equality  = std::equal_to<Key>,
+          generic::allocator                 Allocator = std::allocator<Key>>
+requires std::copyable<Value>  //
+class background_flat_map {
+ public:
+  using container   = flat_map<Key, Value, Hasher, Equality, Allocator>;
+  using key_set     = flat_set<Key, Hasher, Equality, Allocator>;
+  using key_type    = Key;
+  using mapped_type = Value;
+  using allocator   = Allocator;
+  using hasher      = Hasher;
+  using equality    = Equality;
+  using size_type   = typename container::size_type;
+  using real        = typename container::real;
+  using iterator    = typename container::iterator;
+
+  background_flat_map() = default;
+
+  explicit background_flat_map(size_type s,
+                               real      soft = 0.6,
+                               real      m    = 0.8,
+                               hasher    h    = {},
+                               equality  e    = {},
+                               allocator a    = {})
+      : table(s, m, h, e, a),
+        log(0, m, h, e, a),
+        erased(0, m, h, e, a),
+        hash{h},
+        equal{e},
+        alloc{a},
+        soft_load_ratio{soft} {
+    assert((0 < soft) && (soft < m));
+  }
+
+  /// The destructor waits for running background workers.
+  ~background_flat_map() noexcept {
+    if (next.valid()) next.wait();
+    for (auto& disposal : disposals)
+      disposal.wait();
+  }
+
+  // The frozen table is referenced by the background worker.
+  background_flat_map(const background_flat_map&) = delete;
+  background_flat_map& operator=(const background_flat_map&) = delete;
+  background_flat_map(background_flat_map&&)                 = delete;
+  background_flat_map& operator=(background_flat_map&&) = delete;
+
+  /// Checks if a background rehash is currently running.
+  bool rehashing() const noexcept { return next.valid(); }
+
+  /// Waits for a running background rehash and swaps in the new table.
+  /// Afterwards, all elements are stored inside a single table again.
+  void synchronize() {
+    if (rehashing()) finish();
+  }
+
+  /// Checks if the map contains zero elements.
+  bool empty() const noexcept { return size() == 0; }
+
+  /// Returns the count of inserted elements.
+  auto size() const noexcept { return rehashing() ? load : table.size(); }
+
+  /// Returns the capacity of the current table.
+  /// While rehashing, this is the capacity of the frozen table.
+  auto capacity() const noexcept { return table.capacity(); }
+
+  /// Returns the current load factor of the map.
+  auto load_factor() const noexcept { return real(size()) / capacity(); }
+
+  /// Returns the maximum load factor of the underlying tables.
+  auto max_load_factor() const noexcept { return table.max_load_factor(); }
+
+  /// Returns the load factor which starts a background rehash.
+  auto soft_load_factor() const noexcept { return soft_load_ratio; }
+
+  /// Sets the load factor which starts a background rehash.
+  /// It has to be smaller than the maximum load factor.
+  void set_soft_load_factor(real x) {
+    assert((0 < x) && (x < max_load_factor()));
+    soft_load_ratio = x;
+  }
+
+  /// Return an iterator to the beginning of the map.
+  /// This waits for a running background rehash.
+  auto begin() -> iterator {
+    synchronize();
+    return table.begin();
+  }
+
+  /// Return an iterator to the end of the map.
+  /// This waits for a running background rehash.
+  auto end() -> iterator {
+    synchronize();
+    return table.end();
+  }
+
+  /// Reserves enough memory such that 'count' elements could be inserted
+  /// without starting a background rehash. This waits for a running background
+  /// rehash and may rehash synchronously.
+  void reserve(size_type count) {
+    synchronize();
+    table.reserve(std::ceil(count * max_load_factor() / soft_load_ratio));
+  }
+
+  /// Clears all the contents of the map.
+  /// This waits for a running background rehash.
+  void clear() {
+    synchronize();
+    table.clear();
+  }
+
+  /// Checks if an element with given key has already
+  /// been inserted into the map.
+  bool contains(const key_type& key) const noexcept {
+    return lookup_value(key) != nullptr;
+  }
+
+  /// Returns a constant reference to the mapped value of the given key. If no
+  /// such element exists, an exception of type std::invalid_argument is thrown.
+  auto operator()(const key_type& key) const -> const mapped_type& {
+    if (const auto value = lookup_value(key)) return *value;
+    detail::raise<std::invalid_argument>("Failed to find the given key.");
+  }
+
+  /// Insert a given element into the map. If the key has already been
+  /// inserted, the function throws an exception of type 'std::invalid_argument'.
+  template <generic::forwardable<key_type>    K,
+            generic::forwardable<mapped_type> V>
+  void insert(K&& key, V&& value) {
+    prepare_write();
+    if (!rehashing()) {
+      table.insert(std::forward<K>(key), std::forward<V>(value));
+      return;
+    }
+    decltype(auto) k = forward_construct<key_type>(std::forward<K>(key));
+    if (contains(k))
+      detail::raise<std::invalid_argument>(
+          "Failed to insert element that already exists!");
+    ++load;
+    erased.try_remove(k);
+    log.insert(std::forward<decltype(k)>(k), std::forward<V>(value));
+  }
+
+  /// Insert a given element into the map.
+  /// If the key has already been inserted, nothing is done.
+  template <generic::forwardable<key_type>    K,
+            generic::forwardable<mapped_type> V>
+  void try_insert(K&& key, V&& value) {
+    prepare_write();
+    if (!rehashing()) {
+      table.try_insert(std::forward<K>(key), std::forward<V>(value));
+      return;
+    }
+    decltype(auto) k = forward_construct<key_type>(std::forward<K>(key));
+    if (contains(k)) return;
+    ++load;
+    erased.try_remove(k);
+    log.insert(std::forward<decltype(k)>(k), std::forward<V>(value));
+  }
+
+  /// Inserts an element if it not already exists.
+  /// Otherwise, assigns a new value to it.
+  template <generic::forwardable<key_type>    K,
+            generic::forwardable<mapped_type> V>
+  void insert_or_assign(K&& key, V&& value) {
+    prepare_write();
+    if (!rehashing()) {
+      table.insert_or_assign(std::forward<K>(key), std::forward<V>(value));
+      return;
+    }
+    decltype(auto) k = forward_construct<key_type>(std::forward<K>(key));
+    if (!contains(k)) ++load;
+    erased.try_remove(k);
+    log.insert_or_assign(std::forward<decltype(k)>(k), std::forward<V>(value));
+  }
+
+  /// Access the element given by key and assign the given value to it.
+  /// If the key does not exist then an exception of type
+  /// 'std::invalid_argument' is thrown.
+  template <generic::forwardable<mapped_type> V>
+  void assign(const key_type& key, V&& value) {
+    if (!contains(key))
+      detail::raise<std::invalid_argument>("Failed to find the given key.");
+    insert_or_assign(key, std::forward<V>(value));
+  }
+
+  /// Insert or access the element given by the key. While rehashing, an
+  /// element of the frozen table is copied into the log before a reference to
+  /// its value is returned. The reference is invalidated by the next write.
+  template <generic::forwardable<key_type> K>
+  auto operator[](K&& key) -> mapped_type&  //
+      requires std::default_initializable<mapped_type> {
+    prepare_write();
+    if (!rehashing()) return table[std::forward<K>(key)];
+    decltype(auto) k = forward_construct<key_type>(std::forward<K>(key));
+    if (const auto it = log.lookup(k); it != log.end()) return (*it).second;
+    if (const auto value = lookup_value(k))
+      log.insert(k, *value);
+    else {
+      ++load;
+      erased.try_remove(k);
+      log.insert(k);
+    }
+    return log(k);
+  }
+
+  /// Removes an element from the map with the given key.
+  /// If there is no such element, throws an exception of type
+  /// 'std::invalid_argument'.
+  void remove(const key_type& key) {
+    if (!contains(key))
+      detail::raise<std::invalid_argument>(
+          "Failed to remove non-existing key!");
+    try_remove(key);
+  }
+
+  /// Removes an element from the map with the given key.
+  /// If there is no such element, nothing is done.
+  void try_remove(const key_type& key) {
+    prepare_write();
+    if (!rehashing()) {
+      table.try_remove(key);
+      return;
+    }
+    if (!contains(key)) return;
+    --load;
+    log.try_remove(key);
+    if (table.contains(key)) erased.try_insert(key);
+  }
+
+ private:
+  /// Returns a pointer to the value of the given key or 'nullptr' if the key
+  /// has not been inserted. While rehashing, the log overrides the table.
+  auto lookup_value(const key_type& key) const noexcept -> const mapped_type* {
+    if (rehashing()) {
+      if (const auto it = log.lookup(key); it != log.end())
+        return &(*it).second;
+      if (erased.contains(key)) return nullptr;
+    }
+    if (const auto it = table.lookup(key); it != table.end())
+      return &(*it).second;
+    return nullptr;
+  }
+
+  /// Finishes a completed background rehash or starts a new one when the
+  /// soft load factor has been reached. Never blocks the calling thread.
+  void prepare_write() {
+    if (rehashing()) {
+      if (ready.load(std::memory_order_acquire)) finish();
+      return;
+    }
+    if (table.load_factor() >= soft_load_ratio) start();
+  }
+
+  /// Freezes the current table and starts building a table with twice its
+  /// capacity on a background worker.
+  void start() {
+    load = table.size();
+    ready.store(false, std::memory_order_relaxed);
+    next = std::async(std::launch::async, [this] {
+      // A failing worker has to be noticed by the next write as well.
+      struct signal {
+        std::atomic<bool>& ready;
+        ~signal() { ready.store(true, std::memory_order_release); }
+      } guard{ready};
+      const auto& frozen = table;
+      container   result(0, frozen.max_load_factor(), hash, equal, alloc);
+      result.reserve_capacity(frozen.capacity() << 1);
+      for (const auto& [k, v] : frozen)
+        result.nocheck_static_insert(k, v);
+      return result;
+    });
+  }
+
+  /// Waits for the background worker, replays the log into the new table, and
+  /// swaps it in. The old table is handed to a background worker for
+  /// destruction. If the worker or the replay fails, the log is replayed into
+  /// the frozen table instead and the exception is rethrown. Should this fail
+  /// as well, the map keeps rehashing and the next write tries again.
+  void finish() {
+    LYRAHGAMES_ROBIN_HOOD_TRY {
+      auto result = next.get();
+      replay(result);
+      assert(result.size() == load);
+      table.swap(result);
+      log.clear();
+      erased.clear();
+      // Destroying or reassigning the future of an unfinished disposal would
+      // block. So, pending disposals are kept and only finished ones are freed.
+      std::erase_if(disposals, [](const auto& disposal) {
+        using namespace std::chrono_literals;
+        return disposal.wait_for(0s) == std::future_status::ready;
+      });
+      disposals.push_back(result.dispose_async());
+    }
+    LYRAHGAMES_ROBIN_HOOD_CATCH {
+      std::promise<container> failure{};
+      failure.set_exception(std::current_exception());
+      next = failure.get_future();
+      replay(table);
+      next = {};
+      log.clear();
+      erased.clear();
+      LYRAHGAMES_ROBIN_HOOD_RETHROW;
+    }
+  }
+
+  /// Applies all logged writes to the given table. Values are copied such
+  /// that the log stays complete if this fails. Replaying twice is harmless.
+  void replay(container& t) const {
+    for (const auto& k : erased)
+      t.try_remove(k);
+    for (const auto& [k, v] : log)
+      t.insert_or_assign(k, v);
+  }
+
+  container                      table{};
+  container                      log{};
+  key_set                        erased{};
+  hasher                         hash{};
+  equality                       equal{};
+  allocator                      alloc{};
+  real                           soft_load_ratio = 0.6;
+  size_type                      load            = 0;
+  std::atomic<bool>              ready           = false;
+  std::future<container>         next{};
+  std::vector<std::future<void>> disposals{};
+};
+
+}  // namespace lyrahgames::robin_hood
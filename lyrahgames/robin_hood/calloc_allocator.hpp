@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+//
+#include <lyrahgames/robin_hood/detail/raise.hpp>
+
+namespace lyrahgames::robin_hood {
+
+/// \class calloc_allocator calloc_allocator.hpp
+/// Stateless allocator based on 'malloc' and 'calloc'. The flat containers
+/// request their PSL arrays by 'allocate_zeroed' and do not need to fill them
+/// afterwards. For huge allocations, 'calloc' hands out fresh pages of the
+/// kernel which are already zero. Such pages are only faulted in when they
+/// are touched for the first time. Hence, a huge 'reserve' stays cheap and
+/// the resident memory only grows with the actually used parts of the table.
+template <typename T>
+struct calloc_allocator {
+  using value_type = T;
+
+  static_assert(alignof(T) <= alignof(std::max_align_t),
+                "The calloc allocator does not support over-aligned types.");
+
+  calloc_allocator() noexcept = default;
+
+  template <typename U>
+  constexpr calloc_allocator(const calloc_allocator<U>&) noexcept {}
+
+  auto allocate(size_t n) -> T* {
+    if (n == 0) return nullptr;
+    if (n > size_t(-1) / sizeof(T)) detail::raise<std::bad_array_new_length>();
+    const auto p = std::malloc(n * sizeof(T));
+    if (!p) detail::raise<std::bad_alloc>();
+    return static_cast<T*>(p);
+  }
+
+  /// Allocates zero-initialized memory for 'n' objects.
+  auto allocate_zeroed(size_t n) -> T* {
+    if (n == 0) return nullptr;
+    const auto p = std::calloc(n, sizeof(T));
+    if (!p) detail::raise<std::bad_alloc>();
+    return static_cast<T*>(p);
+  }
+
+  void deallocate(T* p, size_t) noexcept { std::free(p); }
+
+  template <typename U>
+  constexpr bool operator==(const calloc_allocator<U>&) const noexcept {
+    return true;
+  }
+};
+
+}  // namespace lyrahgames::robin_hood
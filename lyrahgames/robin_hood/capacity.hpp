@@ -0,0 +1,95 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <ratio>
+//
+#include <lyrahgames/xstd/math.hpp>
+//
+#include <lyrahgames/robin_hood/detail/multiply.hpp>
+
+namespace lyrahgames::robin_hood {
+
+/// Default capacity policy of the flat containers.
+/// Table sizes are powers of two. Hash values are reduced to table indices by
+/// masking their low bits and the capacity is doubled when the table is full.
+/// In the worst case, nearly half of the allocated slots are never used.
+struct power_of_two_capacity {
+  /// Indices are taken from the low bits of hash values.
+  static constexpr bool high_bits = false;
+
+  /// Returns the smallest valid table size not smaller than the given size.
+  static constexpr auto round(size_t size) noexcept -> size_t {
+    return xstd::ceil_pow2(size);
+  }
+
+  /// Returns the table size following the given one when a table is full.
+  static constexpr auto grow(size_t size) noexcept -> size_t {
+    return size << 1;
+  }
+
+  /// Maps the given hash value to an index of a table with the given size.
+  static constexpr auto index(size_t hash, size_t size) noexcept -> size_t {
+    return hash & (size - 1);
+  }
+
+  /// Maps the given hash value to a table index by using its high bits.
+  static constexpr auto high_index(size_t hash, size_t size) noexcept
+      -> size_t {
+    // Shifting in two steps is also defined for a size of one.
+    return (hash >> 1) >> std::countl_zero(size);
+  }
+
+  /// Advances the given index by one in a table with the given size.
+  static constexpr auto next(size_t index, size_t size) noexcept -> size_t {
+    return (index + 1) & (size - 1);
+  }
+};
+
+/// Capacity policy for tables of arbitrary sizes.
+/// Hash values are reduced to table indices by Lemire's multiply-shift range
+/// reduction. It needs no division but uses the high bits of the hash value
+/// only. So, it has to be combined with a hasher whose high bits are well
+/// distributed. The table size is multiplied by the given growth factor when
+/// the table is full. Smaller factors reduce the worst-case memory overshoot
+/// at the cost of more frequent rehashes.
+/// If no mixer is given, the flat containers use 'fibonacci_mixer' for this
+/// policy. @see default_mixer
+template <typename Growth = std::ratio<3, 2>>
+struct arbitrary_capacity {
+  static_assert(Growth::num > Growth::den,
+                "The growth factor of the capacity has to be larger than one.");
+
+  /// Indices are taken from the high bits of hash values.
+  static constexpr bool high_bits = true;
+
+  static constexpr auto round(size_t size) noexcept -> size_t { return size; }
+
+  static constexpr auto grow(size_t size) noexcept -> size_t {
+    return std::max(size + 1, size * Growth::num / Growth::den);
+  }
+
+  static constexpr auto index(size_t hash, size_t size) noexcept -> size_t {
+    return multiply_high(hash, size);
+  }
+
+  /// The range reduction already uses the high bits.
+  static constexpr auto high_index(size_t hash, size_t size) noexcept
+      -> size_t {
+    return index(hash, size);
+  }
+
+  static constexpr auto next(size_t index, size_t size) noexcept -> size_t {
+    ++index;
+    return (index == size) ? 0 : index;
+  }
+
+  /// Returns the upper half of the full product of the given numbers.
+  static constexpr auto multiply_high(size_t x, size_t y) noexcept -> size_t {
+    static_assert(sizeof(size_t) == 8);
+    return detail::multiply(x, y).second;
+  }
+};
+
+}  // namespace lyrahgames::robin_hood
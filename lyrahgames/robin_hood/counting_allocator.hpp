@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace lyrahgames::robin_hood {
+
+/// Global statistics of all allocations done by 'counting_allocator'.
+/// Mainly used by benchmarks and tests to compare memory footprints.
+struct allocation_counter {
+  /// Returns the count of currently allocated bytes.
+  static auto bytes() noexcept { return current.load(); }
+
+  /// Returns the maximal count of allocated bytes since the last reset.
+  static auto peak_bytes() noexcept { return peak.load(); }
+
+  /// Returns the count of allocations since the last reset.
+  static auto allocations() noexcept { return count.load(); }
+
+  /// Sets the peak to the currently allocated bytes
+  /// and the count of allocations to zero.
+  static void reset() noexcept {
+    peak  = current.load();
+    count = 0;
+  }
+
+  static void allocate(size_t n) noexcept {
+    const auto c = current.fetch_add(n) + n;
+    auto       p = peak.load();
+    while ((p < c) && !peak.compare_exchange_weak(p, c)) {
+    }
+    ++count;
+  }
+
+  static void deallocate(size_t n) noexcept { current -= n; }
+
+  static inline std::atomic<size_t> current{0};
+  static inline std::atomic<size_t> peak{0};
+  static inline std::atomic<size_t> count{0};
+};
+
+/// \class counting_allocator counting_allocator.hpp
+/// Allocator on top of 'std::allocator' that reports all
+/// allocations and deallocations to 'allocation_counter'.
+template <typename T>
+struct counting_allocator {
+  using value_type = T;
+
+  counting_allocator() noexcept = default;
+
+  template <typename U>
+  constexpr counting_allocator(const counting_allocator<U>&) noexcept {}
+
+  auto allocate(size_t n) -> T* {
+    const auto p = std::allocator<T>{}.allocate(n);
+    allocation_counter::allocate(n * sizeof(T));
+    return p;
+  }
+
+  void deallocate(T* p, size_t n) noexcept {
+    allocation_counter::deallocate(n * sizeof(T));
+    std::allocator<T>{}.deallocate(p, n);
+  }
+
+  template <typename U>
+  constexpr bool operator==(const counting_allocator<U>&) const noexcept {
+    return true;
+  }
+};
+
+}  // namespace lyrahgames::robin_hood
@@ -8,22 +8,22 @@ struct basic_iterator {
   using table_pointer = std::conditional_t<constant, const table*, table*>;
   using size_type     = typename traits::size_type;
 
-  basic_iterator& operator++() noexcept {
+  constexpr basic_iterator& operator++() noexcept {
     do {
       ++index;
     } while ((index < base->size) && base->empty(index));
     return *this;
   }
 
-  basic_iterator operator++(int) noexcept {
+  constexpr basic_iterator operator++(int) noexcept {
     auto ip = *this;
     ++(*this);
     return ip;
   }
 
-  auto operator*() const noexcept { return base->entry(index); }
+  constexpr auto operator*() const noexcept { return base->entry(index); }
 
-  bool operator==(basic_iterator it) const noexcept {
+  constexpr bool operator==(basic_iterator it) const noexcept {
     // We do not have to check base equality.
     // Comparing iterators from different instances is undefined behavior.
     // return (base == it.base) && (index == it.index);
@@ -41,27 +41,29 @@ struct basic_iterator_interface {
   using const_iterator = basic_iterator<table, true>;
   using size_type      = typename traits::size_type;
 
-  decltype(auto) that() const noexcept {
+  constexpr decltype(auto) that() const noexcept {
     return static_cast<const table*>(this);
   }
 
-  decltype(auto) that() noexcept { return static_cast<table*>(this); }
+  constexpr decltype(auto) that() noexcept { return static_cast<table*>(this); }
 
-  auto begin() noexcept -> iterator {
+  constexpr auto begin() noexcept -> iterator {
     for (size_type i = 0; i < that()->size; ++i)
       if (!that()->empty(i)) return {that(), i};
     return {that(), that()->size};
   }
 
-  auto begin() const noexcept -> const_iterator {
+  constexpr auto begin() const noexcept -> const_iterator {
     for (size_type i = 0; i < that()->size; ++i)
       if (!that()->empty(i)) return {that(), i};
     return {that(), that()->size};
   }
 
-  auto end() noexcept -> iterator { return {that(), that()->size}; }
+  constexpr auto end() noexcept -> iterator { return {that(), that()->size}; }
 
-  auto end() const noexcept -> const_iterator { return {that(), that()->size}; }
+  constexpr auto end() const noexcept -> const_iterator {
+    return {that(), that()->size};
+  }
 };
 
 }  // namespace lyrahgames::robin_hood::detail
\ No newline at end of file
@@ -5,12 +5,17 @@
 #include <iomanip>
 #include <iostream>
 #include <memory>
+#include <type_traits>
 //
 #include <lyrahgames/xstd/swap.hpp>
 //
+#include <lyrahgames/robin_hood/memory_usage.hpp>
 #include <lyrahgames/robin_hood/meta.hpp>
 //
 #include <lyrahgames/robin_hood/detail/basic_iterator.hpp>
+#include <lyrahgames/robin_hood/detail/pages.hpp>
+#include <lyrahgames/robin_hood/detail/parallel.hpp>
+#include <lyrahgames/robin_hood/detail/raise.hpp>
 
 namespace lyrahgames::robin_hood::detail {
 
@@ -38,6 +43,22 @@ struct flat_key_value_table : public basic_iterator_interface<
       allocator>::template rebind_alloc<value_type>;
   using value_allocator = std::allocator_traits<basic_value_allocator>;
 
+  static constexpr bool propagate_on_copy_assignment =
+      key_allocator::propagate_on_container_copy_assignment::value;
+  static constexpr bool propagate_on_move_assignment =
+      key_allocator::propagate_on_container_move_assignment::value;
+  static constexpr bool propagate_on_swap =
+      key_allocator::propagate_on_container_swap::value;
+  static constexpr bool allocator_always_equal =
+      key_allocator::is_always_equal::value;
+  static constexpr bool trivially_destructible =
+      std::is_trivially_destructible_v<key_type> &&
+      std::is_trivially_destructible_v<value_type>;
+  /// PSL arrays obtained as zero-initialized memory do not need to be filled.
+  /// So, pages of huge tables are only faulted in when they are used.
+  static constexpr bool zeroed_psls =
+      generic::zeroing_allocator<basic_psl_allocator>;
+
   using iterator =
       basic_iterator<flat_key_value_table<key_type, value_type, allocator>,
                      false>;
@@ -47,98 +68,293 @@ struct flat_key_value_table : public basic_iterator_interface<
 
   flat_key_value_table() = default;
 
-  explicit flat_key_value_table(size_type s, allocator a = {})
-      : alloc{a}, size{s} {
+  constexpr explicit flat_key_value_table(size_type s, allocator a = {})
+      : psl_alloc{a}, key_alloc{a}, value_alloc{a}, size{s} {
     init();
   }
 
-  virtual ~flat_key_value_table() noexcept { free(); }
+  constexpr ~flat_key_value_table() noexcept { free(); }
 
-  flat_key_value_table(const flat_key_value_table& t)
-      : alloc{t.alloc}, size{t.size} {
+  constexpr flat_key_value_table(const flat_key_value_table& t)
+      : psl_alloc{psl_allocator::select_on_container_copy_construction(
+            t.psl_alloc)},
+        key_alloc{key_allocator::select_on_container_copy_construction(
+            t.key_alloc)},
+        value_alloc{value_allocator::select_on_container_copy_construction(
+            t.value_alloc)},
+        size{t.size} {
     copy(t);
   }
 
-  flat_key_value_table& operator=(const flat_key_value_table& t) {
+  template <generic::execution_policy Policy>
+  flat_key_value_table(Policy&& policy, const flat_key_value_table& t)
+      : psl_alloc{psl_allocator::select_on_container_copy_construction(
+            t.psl_alloc)},
+        key_alloc{key_allocator::select_on_container_copy_construction(
+            t.key_alloc)},
+        value_alloc{value_allocator::select_on_container_copy_construction(
+            t.value_alloc)},
+        size{t.size} {
+    copy(policy, t);
+  }
+
+  constexpr flat_key_value_table& operator=(const flat_key_value_table& t) {
+    if (this == &t) return *this;
     free();
-    alloc = t.alloc;
-    size  = t.size;
+    if constexpr (propagate_on_copy_assignment) {
+      psl_alloc   = t.psl_alloc;
+      key_alloc   = t.key_alloc;
+      value_alloc = t.value_alloc;
+    }
+    size = t.size;
     copy(t);
     return *this;
   }
 
-  flat_key_value_table(flat_key_value_table&& t) noexcept { swap(t); }
+  constexpr flat_key_value_table(flat_key_value_table&& t) noexcept
+      : psl_alloc{t.psl_alloc},
+        key_alloc{t.key_alloc},
+        value_alloc{t.value_alloc} {
+    swap_data(t);
+  }
 
-  flat_key_value_table& operator=(flat_key_value_table&& t) noexcept {
-    swap(t);
+  /// If the allocators are not allowed to be moved and are not equal,
+  /// the elements have to be moved one by one into new memory.
+  constexpr flat_key_value_table& operator=(flat_key_value_table&& t) noexcept(
+      propagate_on_move_assignment || allocator_always_equal) {
+    if constexpr (propagate_on_move_assignment) {
+      using std::swap;
+      swap(psl_alloc, t.psl_alloc);
+      swap(key_alloc, t.key_alloc);
+      swap(value_alloc, t.value_alloc);
+    } else if (key_alloc != t.key_alloc) {
+      free();
+      size = t.size;
+      init();
+      for (size_type i = 0; i < t.size; ++i) {
+        if (t.empty(i)) continue;
+        construct_key(i, std::move(t.keys[i]));
+        construct_value(i, std::move(t.values[i]));
+        psls[i] = t.psls[i];
+      }
+      return *this;
+    }
+    swap_data(t);
     return *this;
   }
 
-  bool empty() const noexcept { return size == 0; }
+  constexpr auto get_allocator() const noexcept -> allocator {
+    return allocator(key_alloc);
+  }
+
+  constexpr bool empty() const noexcept { return size == 0; }
 
-  bool empty(size_type index) const noexcept { return psls[index] == 0; }
+  constexpr bool empty(size_type index) const noexcept {
+    return psls[index] == 0;
+  }
 
-  auto entry(size_type index) noexcept {
+  constexpr auto entry(size_type index) noexcept {
     return std::pair<const key_type&, value_type&>{keys[index], values[index]};
   }
 
-  auto entry(size_type index) const noexcept {
+  constexpr auto entry(size_type index) const noexcept {
     return std::pair<const key_type&, const value_type&>{keys[index],
                                                          values[index]};
   }
 
-  auto index_iterator(size_type index) { return iterator{this, index}; }
+  constexpr auto index_iterator(size_type index) {
+    return iterator{this, index};
+  }
 
-  auto psl(size_type index) noexcept -> psl_type& { return psls[index]; }
+  constexpr auto psl(size_type index) noexcept -> psl_type& {
+    return psls[index];
+  }
 
-  auto psl(size_type index) const noexcept -> const psl_type& {
+  constexpr auto psl(size_type index) const noexcept -> const psl_type& {
     return psls[index];
   }
 
-  auto key(size_type index) noexcept -> key_type& { return keys[index]; }
+  constexpr auto key(size_type index) noexcept -> key_type& {
+    return keys[index];
+  }
 
-  auto key(size_type index) const noexcept -> const key_type& {
+  constexpr auto key(size_type index) const noexcept -> const key_type& {
     return keys[index];
   }
 
-  auto value(size_type index) noexcept -> value_type& { return values[index]; }
+  constexpr auto value(size_type index) noexcept -> value_type& {
+    return values[index];
+  }
 
-  auto value(size_type index) const noexcept -> const value_type& {
+  constexpr auto value(size_type index) const noexcept -> const value_type& {
     return values[index];
   }
 
-  void swap(flat_key_value_table& t) noexcept {
-    std::swap(alloc, t.alloc);
+  /// Non-owning copy of the table state used by optimistic readers.
+  struct snapshot_type {
+    auto psl(size_type index) const noexcept -> psl_type { return psls[index]; }
+
+    auto key(size_type index) const noexcept -> const key_type& {
+      return keys[index];
+    }
+
+    auto value(size_type index) const noexcept -> const value_type& {
+      return values[index];
+    }
+
+    size_type         size   = 0;
+    const psl_type*   psls   = nullptr;
+    const key_type*   keys   = nullptr;
+    const value_type* values = nullptr;
+  };
+
+  auto snapshot() const noexcept -> snapshot_type {
+    return {size, psls, keys, values};
+  }
+
+  /// Tables of trivially copyable elements are grown in place
+  /// if all their allocators are able to reallocate memory.
+  static constexpr bool growable_in_place =
+      std::is_trivially_copyable_v<key_type> &&
+      std::is_trivially_copyable_v<value_type> &&
+      generic::reallocatable_allocator<basic_psl_allocator> &&
+      generic::reallocatable_allocator<basic_key_allocator> &&
+      generic::reallocatable_allocator<basic_value_allocator>;
+
+  /// Copy of an element which is temporarily taken out of the table.
+  struct element_type {
+    key_type   key;
+    value_type value;
+  };
+
+  constexpr auto element(size_type index) const noexcept -> element_type {
+    return {keys[index], values[index]};
+  }
+
+  constexpr void set_element(size_type index, const element_type& e) noexcept {
+    keys[index]   = e.key;
+    values[index] = e.value;
+  }
+
+  /// Grows the arrays to the given size by reallocation. Old slots keep their
+  /// elements and new slots are empty. On failure, the table is unchanged.
+  void grow(size_type s) requires growable_in_place {
+    psls = psl_alloc.reallocate(psls, size, s);
+    LYRAHGAMES_ROBIN_HOOD_TRY {
+      keys = key_alloc.reallocate(keys, size, s);
+      LYRAHGAMES_ROBIN_HOOD_TRY {
+        values = value_alloc.reallocate(values, size, s);
+      }
+      LYRAHGAMES_ROBIN_HOOD_CATCH {
+        keys = key_alloc.reallocate(keys, s, size);
+        LYRAHGAMES_ROBIN_HOOD_RETHROW;
+      }
+    }
+    LYRAHGAMES_ROBIN_HOOD_CATCH {
+      psls = psl_alloc.reallocate(psls, s, size);
+      LYRAHGAMES_ROBIN_HOOD_RETHROW;
+    }
+    if constexpr (!zeroed_psls) std::fill(psls + size, psls + s, 0);
+    size = s;
+  }
+
+  /// Allocators are only swapped if they propagate on swap.
+  /// Otherwise, they are assumed to be equal.
+  constexpr void swap(flat_key_value_table& t) noexcept {
+    if constexpr (propagate_on_swap) {
+      using std::swap;
+      swap(psl_alloc, t.psl_alloc);
+      swap(key_alloc, t.key_alloc);
+      swap(value_alloc, t.value_alloc);
+    }
+    swap_data(t);
+  }
+
+  constexpr void swap_data(flat_key_value_table& t) noexcept {
     std::swap(size, t.size);
     std::swap(psls, t.psls);
     std::swap(keys, t.keys);
     std::swap(values, t.values);
   }
 
-  void clear() noexcept {
-    for (size_type i = 0; i < size; ++i) {
-      if (empty(i)) continue;
-      destroy(i);
+  constexpr void clear() noexcept { clear(0, size); }
+
+  constexpr void clear(size_type first, size_type last) noexcept {
+    if constexpr (trivially_destructible) {
+      std::fill(psls + first, psls + last, 0);
+    } else {
+      for (size_type i = first; i < last; ++i) {
+        if (empty(i)) continue;
+        destroy(i);
+      }
     }
   }
 
+  template <generic::execution_policy Policy>
+  void clear(Policy&& policy) {
+    parallel::for_each_chunk(
+        policy, size,
+        [this](size_type, size_type first, size_type last) {
+          clear(first, last);
+        });
+  }
+
+  /// Touches the pages of all arrays belonging to the given chunk of slots.
+  void prefault(size_type first, size_type last) noexcept {
+    pages::touch(psls, first, last);
+    pages::touch(keys, first, last);
+    pages::touch(values, first, last);
+  }
+
+  template <generic::execution_policy Policy>
+  void prefault(Policy&& policy) {
+    parallel::for_each_chunk(
+        policy, size, [this](size_type, size_type first, size_type last) {
+          prefault(first, last);
+        });
+  }
+
   // private:
-  void init() {
+  constexpr void init() {
     if (!size) return;
     allocate();
-    std::fill(psls, psls + size, 0);
+    if constexpr (!zeroed_psls) std::fill(psls, psls + size, 0);
   }
 
-  void free() {
+  constexpr void free() {
     if (empty()) return;
-    clear();
+    if constexpr (!trivially_destructible) clear();
     deallocate();
   }
 
+  /// Forgets all elements and the memory without destroying and deallocating
+  /// them. Afterwards, the table is empty and owns no memory.
+  constexpr void release() noexcept {
+    size   = 0;
+    psls   = nullptr;
+    keys   = nullptr;
+    values = nullptr;
+  }
+
+  /// Returns the bytes allocated for the arrays of the table.
+  auto memory_usage() const noexcept -> robin_hood::memory_usage {
+    return {.psl_bytes   = size * sizeof(psl_type),
+            .key_bytes   = size * sizeof(key_type),
+            .value_bytes = size * sizeof(value_type)};
+  }
+
   /// Assumes old stuff has been deallocated.
-  void copy(const flat_key_value_table& t) {
+  constexpr void copy(const flat_key_value_table& t) {
     init();
-    for (size_type i = 0; i < t.size; ++i) {
+    copy(t, 0, t.size);
+  }
+
+  /// Copies the elements of the given chunk of slots.
+  /// Assumes the table has been initialized with the same size.
+  constexpr void copy(const flat_key_value_table& t,
+                      size_type                   first,
+                      size_type                   last) {
+    for (size_type i = first; i < last; ++i) {
       if (t.empty(i)) continue;
       psls[i] = t.psls[i];
       construct_key(i, t.keys[i]);
@@ -146,64 +362,85 @@ struct flat_key_value_table : public basic_iterator_interface<
     }
   }
 
-  void allocate() {
-    basic_key_allocator   key_alloc   = alloc;
-    basic_value_allocator value_alloc = alloc;
-    basic_psl_allocator   psl_alloc   = alloc;
+  /// Assumes old stuff has been deallocated.
+  template <generic::execution_policy Policy>
+  void copy(Policy&& policy, const flat_key_value_table& t) {
+    init();
+    parallel::for_each_chunk(
+        policy, t.size,
+        [this, &t](size_type, size_type first, size_type last) {
+          copy(t, first, last);
+        });
+  }
 
+  constexpr void allocate() {
     keys   = key_allocator::allocate(key_alloc, size);
     values = value_allocator::allocate(value_alloc, size);
-    psls   = psl_allocator::allocate(psl_alloc, size);
+    if constexpr (zeroed_psls)
+      psls = psl_alloc.allocate_zeroed(size);
+    else
+      psls = psl_allocator::allocate(psl_alloc, size);
   }
 
-  void deallocate() {
-    basic_key_allocator   key_alloc   = alloc;
-    basic_value_allocator value_alloc = alloc;
-    basic_psl_allocator   psl_alloc   = alloc;
-
+  constexpr void deallocate() {
     psl_allocator::deallocate(psl_alloc, psls, size);
     value_allocator::deallocate(value_alloc, values, size);
     key_allocator::deallocate(key_alloc, keys, size);
   }
 
   template <typename... arguments>
-  void construct_key(size_type index, arguments&&... args)  //
+  constexpr void construct_key(size_type index, arguments&&... args)  //
       requires std::constructible_from<key_type, arguments...> {
-    basic_key_allocator key_alloc = alloc;
     key_allocator::construct(key_alloc, keys + index,
                              std::forward<arguments>(args)...);
   }
 
-  void destroy_key(size_type index) noexcept {
-    basic_key_allocator key_alloc = alloc;
+  constexpr void destroy_key(size_type index) noexcept {
     key_allocator::destroy(key_alloc, keys + index);
   }
 
   template <typename... arguments>
-  void construct_value(size_type index, arguments&&... args)  //
+  constexpr void construct_value(size_type index, arguments&&... args)  //
       requires std::constructible_from<value_type, arguments...> {
-    basic_value_allocator value_alloc = alloc;
     value_allocator::construct(value_alloc, values + index,
                                std::forward<arguments>(args)...);
   }
 
-  void destroy_value(size_type index) noexcept {
-    basic_value_allocator value_alloc = alloc;
+  /// Constructs the value from the result of the given function. A result of
+  /// the value type itself is built in place without an additional move.
+  template <std::invocable F>
+  constexpr void construct_value_with(size_type index, F&& f) {
+    using result_type = std::invoke_result_t<F>;
+    if constexpr (std::same_as<result_type, value_type>) {
+      struct deferred {
+        F& f;
+        constexpr operator result_type() const {
+          return std::invoke(std::forward<F>(f));
+        }
+      };
+      construct_value(index, deferred{f});
+    } else
+      construct_value(index, std::invoke(std::forward<F>(f)));
+  }
+
+  constexpr void destroy_value(size_type index) noexcept {
     value_allocator::destroy(value_alloc, values + index);
   }
 
-  void destroy(size_type index) noexcept {
+  constexpr void destroy(size_type index) noexcept {
     destroy_key(index);
     destroy_value(index);
     psls[index] = 0;
   }
 
-  void move_construct(size_type index, size_type from) {
+  constexpr void move_construct(size_type index, size_type from) {
     construct_key(index, std::move(keys[from]));
     construct_value(index, std::move(values[from]));
   }
 
-  void move_construct_or_assign(size_type index, psl_type p, iterator it) {
+  constexpr void move_construct_or_assign(size_type index,
+                                          psl_type  p,
+                                          iterator  it) {
     if (empty(index)) {
       psls[index] = p;
       construct_key(index, std::move(it.base->keys[it.index]));
@@ -215,22 +452,24 @@ struct flat_key_value_table : public basic_iterator_interface<
     values[index] = std::move(it.base->values[it.index]);
   }
 
-  void swap(size_type first, size_type second) {
+  constexpr void swap(size_type first, size_type second) {
     using xstd::swap;
     swap(keys[first], keys[second]);
     swap(values[first], values[second]);
   }
 
-  void move(size_type to, size_type from) {
+  constexpr void move(size_type to, size_type from) {
     keys[to]   = std::move(keys[from]);
     values[to] = std::move(values[from]);
   }
 
-  allocator   alloc  = {};
-  size_type   size   = 0;
-  psl_type*   psls   = nullptr;
-  key_type*   keys   = nullptr;
-  value_type* values = nullptr;
+  [[no_unique_address]] basic_psl_allocator   psl_alloc   = {};
+  [[no_unique_address]] basic_key_allocator   key_alloc   = {};
+  [[no_unique_address]] basic_value_allocator value_alloc = {};
+  size_type                                   size        = 0;
+  psl_type*                                   psls        = nullptr;
+  key_type*                                   keys        = nullptr;
+  value_type*                                 values      = nullptr;
 };
 
 template <generic::key Key, generic::value Value, generic::allocator Allocator>
@@ -1,78 +1,210 @@
 #pragma once
+#include <algorithm>
 #include <cassert>
+#include <functional>
+#include <future>
+#include <ios>
+#include <istream>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <vector>
 //
 #include <lyrahgames/xstd/math.hpp>
+//
+#include <lyrahgames/robin_hood/capacity.hpp>
+#include <lyrahgames/robin_hood/hash.hpp>
+#include <lyrahgames/robin_hood/hashed_key.hpp>
+#include <lyrahgames/robin_hood/insert_status.hpp>
+#include <lyrahgames/robin_hood/memory_usage.hpp>
+#include <lyrahgames/robin_hood/mixer.hpp>
+#include <lyrahgames/robin_hood/serialization.hpp>
+#include <lyrahgames/robin_hood/synchronization.hpp>
+//
+#include <lyrahgames/robin_hood/detail/parallel.hpp>
+#include <lyrahgames/robin_hood/detail/probing.hpp>
+#include <lyrahgames/robin_hood/detail/raise.hpp>
 
 namespace lyrahgames::robin_hood::detail {
 
 template <typename Table,
           generic::hasher<typename Table::key_type>               Hasher,
-          generic::equivalence_relation<typename Table::key_type> Equality>
+          generic::equivalence_relation<typename Table::key_type> Equality,
+          typename Synchronization = unsynchronized,
+          typename Capacity        = power_of_two_capacity,
+          typename Mixer           = default_mixer<Capacity>>
 struct hash_base {
-  using container      = Table;
-  using key_type       = typename container::key_type;
-  using allocator      = typename container::allocator;
-  using hasher         = Hasher;
-  using equality       = Equality;
-  using real           = double;
-  using size_type      = typename container::size_type;
-  using psl_type       = typename container::psl_type;
-  using iterator       = typename container::iterator;
-  using const_iterator = typename container::const_iterator;
+  using container       = Table;
+  using key_type        = typename container::key_type;
+  using allocator       = typename container::allocator;
+  using hasher          = Hasher;
+  using equality        = Equality;
+  using synchronization = Synchronization;
+  using capacity_policy = Capacity;
+  using mixer           = Mixer;
+  using probing         = detail::probing<capacity_policy, mixer>;
+  using real            = double;
+  using size_type       = typename container::size_type;
+  using psl_type        = typename container::psl_type;
+  using iterator        = typename container::iterator;
+  using const_iterator  = typename container::const_iterator;
 
   hash_base() = default;
 
-  hash_base(size_type s, real m, hasher h, equality e, allocator a)
+  constexpr hash_base(size_type s, real m, hasher h, equality e, allocator a)
       : table{0, a}, hash{h}, equal{e}, max_load_ratio{m} {
     assert((0 < m) && (m < 1));
     reserve(std::max(size_type{1}, s));
   }
 
-  hash_base(size_type s, hasher h, equality e, allocator a)
+  constexpr hash_base(size_type s, hasher h, equality e, allocator a)
       : hash_base(s, 0.8, h, e, a) {}
 
+  template <generic::execution_policy Policy>
+  hash_base(Policy&& policy, const hash_base& other)
+      : table(policy, other.table),
+        hash{other.hash},
+        equal{other.equal},
+        load{other.load},
+        max_load_ratio{other.max_load_ratio},
+        min_load_ratio{other.min_load_ratio},
+        reseeds{other.reseeds},
+        psl_bound{other.psl_bound} {}
+
   /// Returns the ideal hash index of the given key
   /// if there would be no collision.
-  auto hash_index(const key_type& key) const noexcept -> size_type {
-    const auto mask = table.size - size_type{1};
-    return hash(key) & mask;
+  constexpr auto hash_index(const key_type& key) const noexcept -> size_type {
+    return hash_index(key, table.size);
+  }
+
+  /// Returns the ideal hash index of the given key
+  /// for a table with the given size.
+  constexpr auto hash_index(const key_type& key, size_type size) const noexcept
+      -> size_type {
+    return hashed_index(hash(key), size);
+  }
+
+  /// Returns the ideal index of a key with the given value of the hasher
+  /// for a table with the given size.
+  constexpr auto hashed_index(size_t h, size_type size) const noexcept
+      -> size_type {
+    return probing::index(h, size);
   }
 
   /// Advance the given index to the underlying table by one and return it.
-  auto next(size_type index) const noexcept -> size_type {
-    const auto mask = table.size - size_type{1};
-    return (index + size_type{1}) & mask;
+  constexpr auto next(size_type index) const noexcept -> size_type {
+    return next(index, table.size);
+  }
+
+  /// Advance the given index to a table with the given size by one.
+  constexpr auto next(size_type index, size_type size) const noexcept
+      -> size_type {
+    return probing::next(index, size);
+  }
+
+  /// Marks the beginning of a write operation for the synchronization policy.
+  /// The write operation ends when the returned object is destroyed.
+  constexpr auto write_section() noexcept { return sync.write(); }
+
+  /// Rounds up the given non-negative number. Other than 'std::ceil',
+  /// this may be used in constant expressions.
+  static constexpr auto ceil(real x) noexcept -> size_type {
+    const auto result = size_type(x);
+    return result + (real(result) < x);
   }
 
   /// Checks if the current load factor of the table has reached the maximum
   /// possible load factor until a reallocation has to be done.
-  bool overloaded() const noexcept {
-    return load >= size_type(std::floor(max_load_ratio * table.size));
+  constexpr bool overloaded() const noexcept {
+    return load >= size_type(max_load_ratio * table.size);
   }
 
   /// If the key is contained in the table then this function returns its index,
   /// probe sequence length, and 'true'. Otherwise, it would return the index
   /// where it would have to be inserted with the according probe sequence
   /// length and 'false'.
-  auto lookup_data(const key_type& key) const noexcept
+  constexpr auto lookup_data(const key_type& key) const noexcept
       -> std::tuple<size_type, psl_type, bool> {
-    auto index = hash_index(key);
-    auto psl   = psl_type{1};
-    for (; psl < table.psl(index); ++psl)
-      index = next(index);
-    for (; psl == table.psl(index); ++psl) {
-      if (equal(table.key(index), key)) return {index, psl, true};
-      index = next(index);
+    return basic_lookup_data(table, key);
+  }
+
+  /// Does the same as 'lookup_data' for a key whose value of the hasher has
+  /// already been computed. The hasher is not called.
+  constexpr auto lookup_data(const key_type& key, size_t h) const noexcept
+      -> std::tuple<size_type, psl_type, bool> {
+    return basic_lookup_data(table, key, h);
+  }
+
+  /// Does the same as 'lookup_data' for the given table or table snapshot.
+  template <typename T>
+  constexpr auto basic_lookup_data(const T&        t,
+                                   const key_type& key) const noexcept
+      -> std::tuple<size_type, psl_type, bool> {
+    return basic_lookup_data(t, key, hash(key));
+  }
+
+  template <typename T>
+  constexpr auto basic_lookup_data(const T&        t,
+                                   const key_type& key,
+                                   size_t          h) const noexcept
+      -> std::tuple<size_type, psl_type, bool> {
+    if (bounded()) return bounded_lookup_data(t, key, h);
+    return probing::lookup_data(t, key, h, equal);
+  }
+
+  /// Does the same as 'basic_lookup_data' for tables whose probe sequence
+  /// lengths are bounded by the PSL limit. Both loops are merged into a single
+  /// one whose trip count is known in advance.
+  template <typename T>
+  constexpr auto bounded_lookup_data(const T&        t,
+                                     const key_type& key,
+                                     size_t          h) const noexcept
+      -> std::tuple<size_type, psl_type, bool> {
+    auto index = hashed_index(h, t.size);
+    for (psl_type psl = 1; psl <= psl_bound; ++psl) {
+      const auto p = t.psl(index);
+      if (p < psl) return {index, psl, false};
+      if ((p == psl) && equal(t.key(index), key)) return {index, psl, true};
+      index = next(index, t.size);
+    }
+    return {index, psl_bound + 1, false};
+  }
+
+  /// Looks up the given key without writing to the table state and calls the
+  /// given function with the snapshot of the table, the index, and a boolean
+  /// indicating if the key has been found. This is repeated until no write
+  /// operation interfered. The result of the last call is returned.
+  /// The function must only copy data out of the snapshot.
+  template <typename F>
+  auto optimistic_read(const key_type& key, F&& f) const {
+    while (true) {
+      const auto s = sync.read_begin();
+      const auto t = table.snapshot();
+      // Make sure size and pointers belong to the same table.
+      if (!sync.read_validate(s)) continue;
+      // Default-constructed containers own no table at all.
+      if (t.size == 0) return f(t, size_type{0}, false);
+      const auto [index, psl, found] = basic_lookup_data(t, key);
+      auto result                    = f(t, index, found);
+      if (sync.read_validate(s)) return result;
     }
-    return {index, psl, false};
   }
 
   /// Assumes the given key has not already been inserted and computes table
   /// index and probe sequence length where Robin Hood swapping would have to be
   /// started.
-  auto static_insert_data(const key_type& key) const noexcept
+  constexpr auto static_insert_data(const key_type& key) const noexcept
+      -> std::pair<size_type, psl_type> {
+    return hashed_static_insert_data(hash(key));
+  }
+
+  /// Does the same as 'static_insert_data' for the given value of the hasher.
+  constexpr auto hashed_static_insert_data(size_t h) const noexcept
       -> std::pair<size_type, psl_type> {
-    auto index = hash_index(key);
+    auto index = hashed_index(h, table.size);
     auto psl   = psl_type{1};
     for (; psl <= table.psl(index); ++psl)
       index = next(index);
@@ -83,13 +215,14 @@ struct hash_base {
   /// current and succeeding values along the chain by using Robin Hood
   /// swapping. The first empty entry will be move constructed. After this
   /// operation the original index can be move assigned.
-  void prepare_insert(size_type index) {
-    auto p = table.psl(index) + psl_type{1};
-    auto i = next(index);
+  constexpr void prepare_insert(size_type index) {
+    const auto section = write_section();
+    auto       p       = table.psl(index) + psl_type{1};
+    auto       i       = next(index);
     for (; !table.empty(i); ++p) {
       if (p > table.psl(i)) {
         table.swap(i, index);
-        swap(p, table.psl(i));
+        std::swap(p, table.psl(i));
       }
       i = next(i);
     }
@@ -101,7 +234,11 @@ struct hash_base {
   /// Assumes that index and psl were computed by 'lookup_data'
   /// and that capacity is big enough such that map will not be overloaded.
   template <generic::forward_reference<key_type> K>
-  void basic_static_insert_key(size_type index, psl_type psl, K&& key) {
+  constexpr void basic_static_insert_key(size_type index,
+                                         psl_type  psl,
+                                         K&&       key) {
+    const auto section = write_section();
+
     ++load;
 
     if (table.empty(index)) {
@@ -115,10 +252,28 @@ struct hash_base {
   }
 
   /// Directly sets the new size of the underlying table and rehashes all
-  /// inserted elements into it. The function assumes that the given size is a
-  /// positive power of two.
-  void reallocate_and_rehash(size_type c) {
-    container old_table{c, table.alloc};
+  /// inserted elements into it. The function assumes that the given size is
+  /// positive and valid for the capacity policy. If the PSL limit is exceeded
+  /// afterwards, the table is rehashed again. @see restore_psl_limit
+  constexpr void reallocate_and_rehash(size_type c) {
+    basic_reallocate_and_rehash(c);
+    if (bounded()) restore_psl_limit([] { return false; });
+  }
+
+  /// Does the same as 'reallocate_and_rehash' without regarding the PSL limit.
+  constexpr void basic_reallocate_and_rehash(size_type c) {
+    // Optimistic readers of other synchronization policies
+    // could still be accessing the memory that is moved.
+    if constexpr (container::growable_in_place &&
+                  std::same_as<synchronization, unsynchronized>) {
+      if (c > table.size) {
+        grow_and_rehash_in_place(c);
+        return;
+      }
+    }
+
+    const auto section = write_section();
+    container  old_table{c, table.get_allocator()};
     table.swap(old_table);
     for (size_type i = 0; i < old_table.size; ++i) {
       if (old_table.empty(i)) continue;
@@ -126,14 +281,68 @@ struct hash_base {
       if (!table.empty(index)) prepare_insert(index);
       table.move_construct_or_assign(index, psl, old_table.index_iterator(i));
     }
+    sync.retire(std::move(old_table));
+  }
+
+  /// Grows the table in place to the given size and redistributes all elements
+  /// without allocating a second table. All old elements are marked as pending
+  /// first. Then every pending element is taken out of the table and
+  /// reinserted by Robin Hood swapping. If the insertion reaches a pending
+  /// element, this is evicted and reinserted from its own ideal position.
+  /// Hence, placed elements never skip pending slots which could become empty
+  /// later on and the Robin Hood invariant holds for all placed elements.
+  void grow_and_rehash_in_place(size_type c)  //
+      requires container::growable_in_place {
+    const auto section = write_section();
+
+    constexpr auto pending  = std::numeric_limits<psl_type>::max();
+    const auto     old_size = table.size;
+    table.grow(c);
+    for (size_type i = 0; i < old_size; ++i)
+      if (!table.empty(i)) table.psl(i) = pending;
+
+    for (size_type i = 0; i < old_size; ++i) {
+      if (table.psl(i) != pending) continue;
+      auto e       = table.element(i);
+      table.psl(i) = 0;
+      auto index   = hash_index(e.key);
+      auto psl     = psl_type{1};
+      while (true) {
+        const auto p = table.psl(index);
+        if (p == 0) {
+          table.set_element(index, e);
+          table.psl(index) = psl;
+          break;
+        }
+        if (p == pending) {
+          const auto evicted = table.element(index);
+          table.set_element(index, e);
+          table.psl(index) = psl;
+          e                = evicted;
+          index            = hash_index(e.key);
+          psl              = psl_type{1};
+          continue;
+        }
+        if (p < psl) {
+          const auto displaced = table.element(index);
+          table.set_element(index, e);
+          table.psl(index) = psl;
+          e                = displaced;
+          psl              = p;
+        }
+        index = next(index);
+        ++psl;
+      }
+    }
   }
 
   /// Erase the element at the given table index and move the subsequent
   /// elements one step back. Abort this when an element with probe sequence
   /// length of '1' occurs. Assumes the table entry referenced by the given
   /// index is not empty.
-  void basic_remove(size_type index) {
-    auto next_index = next(index);
+  constexpr void basic_remove(size_type index) {
+    const auto section    = write_section();
+    auto       next_index = next(index);
     while (table.psl(next_index) > 1) {
       table.move(index, next_index);
       table.psl(index) = table.psl(next_index) - 1;
@@ -145,26 +354,82 @@ struct hash_base {
     --load;
   }
 
-  /// Doubles the amount of allocated space of the underlying table and inserts
-  /// all elements again.
-  void double_capacity_and_rehash() { reallocate_and_rehash(table.size << 1); }
+  /// Does the same as 'basic_remove' for an element whose key has been
+  /// inserted but whose value has not been constructed. Subsequent elements
+  /// are therefore move constructed instead of move assigned.
+  constexpr void basic_remove_key(size_type index) {
+    const auto section = write_section();
+    table.destroy_key(index);
+    auto next_index = next(index);
+    while (table.psl(next_index) > 1) {
+      table.move_construct(index, next_index);
+      table.psl(index) = table.psl(next_index) - 1;
+      table.destroy(next_index);
+
+      index      = next_index;
+      next_index = next(next_index);
+    }
+    table.psl(index) = 0;
+    --load;
+  }
+
+  /// Grows the allocated space of the underlying table by the growth factor
+  /// of the capacity policy and inserts all elements again.
+  constexpr void grow_capacity_and_rehash() {
+    reallocate_and_rehash(capacity_policy::grow(table.size));
+  }
 
-  void reserve_capacity(size_type size) {
+  constexpr void reserve_capacity(size_type size) {
     size = std::max(min_capacity, size);
     if (size <= table.size) return;
-    size = ceil_pow2(size);
+    size = capacity_policy::round(size);
     reallocate_and_rehash(size);
   }
 
-  void reserve(size_type count) {
-    count = std::ceil(count / max_load_ratio);
+  constexpr void reserve(size_type count) {
+    count = ceil(count / max_load_ratio);
     reserve_capacity(count);
   }
 
+  /// Rehashes all elements into a smaller table whose size is the given size
+  /// rounded by the capacity policy. If this would not make the table
+  /// smaller, nothing happens. Assumes all elements fit into the new table.
+  constexpr void shrink_capacity(size_type size) {
+    size = capacity_policy::round(std::max(min_capacity, size));
+    if (size >= table.size) return;
+    reallocate_and_rehash(size);
+  }
+
+  /// Shrinks the table to the smallest capacity
+  /// that 'reserve' would choose for the current count of elements.
+  constexpr void shrink_to_fit() {
+    shrink_capacity(ceil(load / max_load_ratio));
+  }
+
+  /// Shrinks the table after a removal if the load factor has fallen below the
+  /// minimum load factor. The new capacity is chosen such that the load factor
+  /// is at most half of the maximum load factor. Together with a minimum load
+  /// factor of less than a quarter of the maximum load factor, neither the
+  /// next insertion nor the next removal is able to trigger a reallocation.
+  constexpr void shrink_if_underloaded() {
+    if (load >= size_type(min_load_ratio * table.size)) return;
+    shrink_capacity(ceil(2 * load / max_load_ratio));
+  }
+
+  /// Sets the minimum load factor for automatic shrinking after removals.
+  /// The function assumes that the given factor lies in [0, max/4).
+  /// A value of zero disables automatic shrinking.
+  constexpr void set_min_load_factor(real x) {
+    assert((0 <= x) && (x < max_load_ratio / 4));
+    min_load_ratio = x;
+    shrink_if_underloaded();
+  }
+
   /// Sets the maximum load factor and possibly triggers a reallocation.
   /// The function assumes that the given factor lies in (0,1).
-  void set_max_load_factor(real x) {
+  constexpr void set_max_load_factor(real x) {
     assert((x > 0) || (x < 1));
+    assert(min_load_ratio < x / 4);
     max_load_ratio = x;
     // Reserve capacity for the number of inserted elements
     // or at least one element.
@@ -172,14 +437,147 @@ struct hash_base {
     reserve(std::max(load, size_t(1)));
   }
 
+  /// Probe sequence length above which an insertion at a low load factor is
+  /// considered to be the result of hash flooding.
+  static constexpr psl_type flood_psl = 64;
+
+  /// Checks if inserting an element with the given probe sequence length
+  /// indicates hash flooding. This is the case if the probe sequence is
+  /// unusually long although the table is less than half full. Only tables
+  /// with a seeded hasher are able to recover from it.
+  constexpr bool flooded(psl_type psl) const noexcept {
+    if constexpr (generic::seeded_hasher<hasher>)
+      return (psl > flood_psl) && (2 * load < max_load_ratio * table.size);
+    else
+      return false;
+  }
+
+  /// Replaces the seed of the hasher by a new random seed and rehashes all
+  /// elements into a table of the same size. Does nothing for hashers
+  /// without a seed.
+  constexpr void reseed_and_rehash() {
+    if constexpr (generic::seeded_hasher<hasher>) {
+      const auto section = write_section();
+
+      basic_reseed_and_rehash();
+      if (bounded()) restore_psl_limit([] { return false; });
+    }
+  }
+
+  /// Does the same as 'reseed_and_rehash' without regarding the PSL limit.
+  constexpr void basic_reseed_and_rehash()  //
+      requires generic::seeded_hasher<hasher> {
+    hash.reseed(random_seed());
+    ++reseeds;
+    basic_reallocate_and_rehash(table.size);
+  }
+
+  /// Checks if probe sequence lengths are bounded by a PSL limit.
+  constexpr bool bounded() const noexcept { return psl_bound != 0; }
+
+  /// Returns the largest probe sequence length that 'basic_static_insert_key'
+  /// would produce for the given index and probe sequence length computed by
+  /// 'lookup_data'. It follows the swapping of 'prepare_insert' without
+  /// modifying the table.
+  constexpr auto insert_psl(size_type index, psl_type psl) const noexcept
+      -> psl_type {
+    if (table.empty(index)) return psl;
+    auto result = psl;
+    auto p      = table.psl(index) + psl_type{1};
+    auto i      = next(index);
+    for (; !table.empty(i); ++p) {
+      if (p > table.psl(i)) {
+        result = std::max(result, p);
+        p      = table.psl(i);
+      }
+      i = next(i);
+    }
+    return std::max(result, p);
+  }
+
+  /// Returns the largest probe sequence length of all elements.
+  constexpr auto max_psl() const noexcept -> psl_type {
+    auto result = psl_type{0};
+    for (size_type i = 0; i < table.size; ++i)
+      result = std::max(result, table.psl(i));
+    return result;
+  }
+
+  /// Rehashes the table until no element exceeds the PSL limit and the given
+  /// predicate is false. A seeded hasher is reseeded first. If this does not
+  /// help, the table grows. To not waste arbitrary amounts of memory for keys
+  /// that always collide, the function throws an exception of type
+  /// 'std::overflow_error' when the table would have to grow although its
+  /// load factor is already less than 1/16. In this case, the hasher and the
+  /// size of the table are rolled back to the ones before the call and the
+  /// limit is removed if elements exceed it such that lookups still find all
+  /// of them.
+  template <typename F>
+  constexpr void restore_psl_limit(F&& violated) {
+    const auto old_size    = table.size;
+    const auto old_hash    = hash;
+    const auto old_reseeds = reseeds;
+
+    [[maybe_unused]] bool reseeded = false;
+    while ((max_psl() > psl_bound) || violated()) {
+      if constexpr (generic::seeded_hasher<hasher>) {
+        if (!reseeded) {
+          reseeded = true;
+          basic_reseed_and_rehash();
+          continue;
+        }
+      }
+      if (16 * load < table.size) {
+        if ((table.size != old_size) || (reseeds != old_reseeds)) {
+          hash    = old_hash;
+          reseeds = old_reseeds;
+          basic_reallocate_and_rehash(old_size);
+        }
+        if (max_psl() > psl_bound) psl_bound = 0;
+        raise<std::overflow_error>(
+            "Failed to keep probe sequence lengths below the PSL limit!");
+      }
+      basic_reallocate_and_rehash(capacity_policy::grow(table.size));
+    }
+  }
+
+  /// Sets the maximal probe sequence length of all elements. Growing
+  /// insertions that would exceed it reseed or grow the table instead.
+  /// Lookups then run a single loop with a known maximal trip count.
+  /// A limit of zero removes the bound.
+  constexpr void set_psl_limit(psl_type x) {
+    const auto section = write_section();
+
+    psl_bound = x;
+    if (bounded()) restore_psl_limit([] { return false; });
+  }
+
+  constexpr auto psl_limit() const noexcept { return psl_bound; }
+
   template <generic::forward_reference<key_type> K>
-  auto basic_insert_key(size_type index, psl_type psl, K&& key) -> size_type {
+  constexpr auto basic_insert_key(size_type index, psl_type psl, K&& key)
+      -> size_type {
     if (overloaded()) {
-      double_capacity_and_rehash();
+      grow_capacity_and_rehash();
       const auto [i, p] = static_insert_data(key);
 
       index = i;
       psl   = p;
+    } else if (flooded(psl)) {
+      reseed_and_rehash();
+      const auto [i, p] = static_insert_data(key);
+
+      index = i;
+      psl   = p;
+    }
+    if (bounded() && (insert_psl(index, psl) > psl_bound)) {
+      restore_psl_limit([&] {
+        const auto [i, p] = static_insert_data(key);
+
+        index = i;
+        psl   = p;
+        return insert_psl(index, psl) > psl_bound;
+      });
     }
     basic_static_insert_key(index, psl, std::forward<K>(key));
     return index;
@@ -187,124 +585,472 @@ struct hash_base {
 
   /// Inserts a given key into table without doing reallocation or checking for
   /// overload. The function assumes that by inserting the given key the maximum
-  /// load factor will not be exceeded. It returns the key index and a boolean
-  /// indicating if it has already been inserted (false) or was inserted at that
-  /// point (true).
+  /// load factor will not be exceeded. It returns the key index and the status
+  /// 'exists' if it has already been inserted or 'inserted' otherwise.
   template <generic::forwardable<key_type> K>
-  auto nocheck_static_insert_key(K&& key) -> std::pair<size_type, bool> {
+  constexpr auto nocheck_static_insert_key(K&& key)
+      -> std::pair<size_type, insert_status> {
     // This makes sure key is constructed
     // if it is not a direct forward reference.
     decltype(auto) k = forward_construct<key_type>(std::forward<K>(key));
     auto [index, psl, found] = lookup_data(k);
-    if (found) return {index, false};
+    if (found) return {index, insert_status::exists};
     basic_static_insert_key(index, psl, std::forward<decltype(k)>(k));
-    return {index, true};
+    return {index, insert_status::inserted};
   }
 
   /// Does the same as 'nocheck_static_insert_key' but additionally checks if an
-  /// overload would occur and abort the process by returning the size of the
-  /// table and false.
+  /// overload would occur or the PSL limit would be exceeded and aborts the
+  /// insertion by returning the size of the table and the according status.
+  /// It never throws by itself and is the core of all static insertions.
   template <generic::forwardable<key_type> K>
-  auto try_static_insert_key(K&& key) -> std::pair<size_type, bool> {
-    if (overloaded()) return {table.size, false};
-    return nocheck_static_insert_key(std::forward<K>(key));
-  }
-
-  template <generic::forwardable<key_type> K>
-  auto static_insert_key(K&& key) -> size_type {
-    // This makes sure key is constructed if it is not a direct forward
-    // reference.
+  constexpr auto try_static_insert_key(K&& key)
+      -> std::pair<size_type, insert_status> {
     decltype(auto) k = forward_construct<key_type>(std::forward<K>(key));
     auto [index, psl, found] = lookup_data(k);
-    if (found)
-      throw std::invalid_argument(
-          "Failed to insert element that already exists!");
-    if (overloaded())
-      throw std::overflow_error("Failed to statically insert given element!");
+    if (found) return {index, insert_status::exists};
+    if (overloaded()) return {table.size, insert_status::overloaded};
+    if (bounded() && (insert_psl(index, psl) > psl_bound))
+      return {table.size, insert_status::psl_limit};
     basic_static_insert_key(index, psl, std::forward<decltype(k)>(k));
+    return {index, insert_status::inserted};
+  }
+
+  /// Turns the index and status returned by one of the non-throwing insertion
+  /// cores into an iterator and the status. Failed insertions refer to the end.
+  constexpr auto insert_result(std::pair<size_type, insert_status> r) noexcept
+      -> std::pair<iterator, insert_status> {
+    return {iterator{&table, r.first}, r.second};
+  }
+
+  /// Applies the given function to the given value and further arguments.
+  /// Functions returning a value, such as 'std::plus', assign the result to
+  /// the value. Functions returning nothing have to modify it in place.
+  template <typename T, typename F, typename... Arguments>
+  static constexpr void update(T& x, F&& f, Arguments&&... args) {
+    if constexpr (std::is_void_v<std::invoke_result_t<F, T&, Arguments...>>)
+      std::invoke(std::forward<F>(f), x, std::forward<Arguments>(args)...);
+    else
+      x = std::invoke(std::forward<F>(f), x, std::forward<Arguments>(args)...);
+  }
+
+  /// Turns the status of a failed insertion into an exception.
+  [[noreturn]] static constexpr void fail(insert_status status) {
+    if (status == insert_status::exists)
+      raise<std::invalid_argument>(
+          "Failed to insert element that already exists!");
+    if (status == insert_status::overloaded)
+      raise<std::overflow_error>("Failed to statically insert given element!");
+    raise<std::overflow_error>(
+        "Failed to statically insert given element within the PSL limit!");
+  }
+
+  template <generic::forwardable<key_type> K>
+  constexpr auto static_insert_key(K&& key) -> size_type {
+    const auto [index, status] = try_static_insert_key(std::forward<K>(key));
+    if (status != insert_status::inserted) fail(status);
     return index;
   }
 
+  /// Inserts the given key with possible reallocation and returns its index
+  /// and the status 'exists' if it has already been inserted or 'inserted'
+  /// otherwise. This is the core of all insertions.
   template <generic::forwardable<key_type> K>
-  auto try_insert_key(K&& key) -> std::pair<size_type, bool> {
+  constexpr auto try_insert_key(K&& key)
+      -> std::pair<size_type, insert_status> {
     // This makes sure key is constructed if it is not a direct forward
     // reference.
     decltype(auto) k = forward_construct<key_type>(std::forward<K>(key));
-    auto [index, psl, found] = lookup_data(k);
-    if (found) return {index, false};
-    index = basic_insert_key(index, psl, std::forward<decltype(k)>(k));
-    return {index, true};
+    const auto h     = hash(k);
+    return try_insert_key(std::forward<decltype(k)>(k), h);
   }
 
+  /// Does the same as 'try_insert_key' for a key whose value of the hasher
+  /// has already been computed. The hasher is only called again for the
+  /// rehashing of a growing or reseeded table.
   template <generic::forwardable<key_type> K>
-  auto insert_key(K&& key) -> size_type {
-    // This makes sure key is constructed if it is not a direct forward
-    // reference.
+  constexpr auto try_insert_key(K&& key, size_t h)
+      -> std::pair<size_type, insert_status> {
     decltype(auto) k = forward_construct<key_type>(std::forward<K>(key));
-    auto [index, psl, found] = lookup_data(k);
-    if (found)
-      throw std::invalid_argument(
-          "Failed to insert element that already exists!");
+    auto [index, psl, found] = lookup_data(k, h);
+    if (found) return {index, insert_status::exists};
     index = basic_insert_key(index, psl, std::forward<decltype(k)>(k));
+    return {index, insert_status::inserted};
+  }
+
+  template <generic::forwardable<key_type> K>
+  constexpr auto insert_key(K&& key) -> size_type {
+    const auto [index, status] = try_insert_key(std::forward<K>(key));
+    if (status != insert_status::inserted) fail(status);
     return index;
   }
 
-  bool try_remove(const key_type& key) {
-    const auto [index, psl, found] = lookup_data(key);
+  constexpr bool try_remove(const key_type& key) {
+    return try_remove(key, hash(key));
+  }
+
+  /// Does the same as 'try_remove' for the given value of the hasher.
+  constexpr bool try_remove(const key_type& key, size_t h) {
+    const auto [index, psl, found] = lookup_data(key, h);
     if (!found) return false;
     basic_remove(index);
+    shrink_if_underloaded();
     return true;
   }
 
-  void remove(const key_type& key) {
-    const auto [index, psl, found] = lookup_data(key);
-    if (!found)
-      throw std::invalid_argument("Failed to remove non-existing key!");
-    basic_remove(index);
+  constexpr void remove(const key_type& key) { remove(key, hash(key)); }
+
+  /// Does the same as 'remove' for the given value of the hasher.
+  constexpr void remove(const key_type& key, size_t h) {
+    if (!try_remove(key, h))
+      raise<std::invalid_argument>("Failed to remove non-existing key!");
   }
 
-  void remove(iterator it) {
+  constexpr void remove(iterator it) {
     assert((it.base == &table) && !table.empty(it.index));
     basic_remove(it.index);
   }
 
-  void remove(const_iterator it) {
+  constexpr void remove(const_iterator it) {
     assert((it.base == &table) && !table.empty(it.index));
     basic_remove(it.index);
   }
 
-  bool empty() const noexcept { return load == 0; }
+  constexpr bool empty() const noexcept { return load == 0; }
+
+  constexpr auto size() const noexcept { return load; }
+
+  constexpr auto capacity() const noexcept { return table.size; }
 
-  auto size() const noexcept { return load; }
+  constexpr auto load_factor() const noexcept {
+    return real(size()) / capacity();
+  }
 
-  auto capacity() const noexcept { return table.size; }
+  constexpr auto max_load_factor() const noexcept { return max_load_ratio; }
 
-  auto load_factor() const noexcept { return real(size()) / capacity(); }
+  constexpr auto min_load_factor() const noexcept { return min_load_ratio; }
 
-  auto max_load_factor() const noexcept { return max_load_ratio; }
+  constexpr auto reseed_count() const noexcept { return reseeds; }
 
-  bool contains(const key_type& key) const noexcept {
+  constexpr bool contains(const key_type& key) const noexcept {
     const auto [index, psl, found] = lookup_data(key);
     return found;
   }
 
-  auto lookup(const key_type& key) noexcept -> iterator {
+  constexpr bool contains(const hashed_key<key_type>& x) const noexcept {
+    const auto [index, psl, found] = lookup_data(x.key, hash_of(x));
+    return found;
+  }
+
+  constexpr auto lookup(const key_type& key) noexcept -> iterator {
     const auto [index, psl, found] = lookup_data(key);
     if (found) return {&table, index};
     return table.end();
   }
 
-  auto lookup(const key_type& key) const noexcept -> const_iterator {
+  constexpr auto lookup(const key_type& key) const noexcept -> const_iterator {
     const auto [index, psl, found] = lookup_data(key);
     if (found) return {&table, index};
     return table.end();
   }
 
-  void clear() {
+  constexpr auto lookup(const hashed_key<key_type>& x) noexcept -> iterator {
+    const auto [index, psl, found] = lookup_data(x.key, hash_of(x));
+    if (found) return {&table, index};
+    return table.end();
+  }
+
+  constexpr auto lookup(const hashed_key<key_type>& x) const noexcept
+      -> const_iterator {
+    const auto [index, psl, found] = lookup_data(x.key, hash_of(x));
+    if (found) return {&table, index};
+    return table.end();
+  }
+
+  /// Returns the given key together with its value of the hasher
+  /// and the current count of reseeds.
+  constexpr auto hashed(const key_type& key) const noexcept
+      -> hashed_key<key_type> {
+    return {key, hash(key), reseeds};
+  }
+
+  /// Returns the stored value of the hasher for the given key. If the hasher
+  /// has been reseeded after the value was computed, it is computed again.
+  constexpr auto hash_of(const hashed_key<key_type>& x) const noexcept
+      -> size_t {
+    return (x.reseeds == reseeds) ? x.hash : hash(x.key);
+  }
+
+  /// Calls the given function for every entry of the table. With a parallel
+  /// execution policy, the slot array is divided into contiguous chunks which
+  /// are processed by multiple threads.
+  template <generic::execution_policy Policy, typename F>
+  void for_each(Policy&& policy, F&& f) {
+    parallel::for_each_chunk(
+        policy, table.size, [&](size_type, size_type first, size_type last) {
+          for (auto i = first; i < last; ++i)
+            if (!table.empty(i)) f(table.entry(i));
+        });
+  }
+
+  template <generic::execution_policy Policy, typename F>
+  void for_each(Policy&& policy, F&& f) const {
+    parallel::for_each_chunk(
+        policy, table.size, [&](size_type, size_type first, size_type last) {
+          for (auto i = first; i < last; ++i)
+            if (!table.empty(i)) f(table.entry(i));
+        });
+  }
+
+  /// Transforms every entry of the table and reduces the results together with
+  /// the initial value. Every chunk is reduced on its own thread and the
+  /// partial results are reduced in the order of their chunks afterwards.
+  /// Hence, 'reduce' has to be associative but not commutative.
+  template <generic::execution_policy Policy,
+            typename T,
+            typename Reduce,
+            typename Transform>
+  auto transform_reduce(Policy&&,
+                        T         init,
+                        Reduce    reduce,
+                        Transform transform) const -> T {
+    const auto count = parallel::chunk_count<Policy>(table.size);
+    std::vector<std::optional<T>> partials(count);
+    parallel::for_each_chunk(
+        count, table.size,
+        [&](size_type chunk, size_type first, size_type last) {
+          auto& partial = partials[chunk];
+          for (auto i = first; i < last; ++i) {
+            if (table.empty(i)) continue;
+            if (partial)
+              partial = reduce(std::move(*partial), transform(table.entry(i)));
+            else
+              partial.emplace(transform(table.entry(i)));
+          }
+        });
+    for (auto& partial : partials)
+      if (partial) init = reduce(std::move(init), std::move(*partial));
+    return init;
+  }
+
+  constexpr void clear() {
+    const auto section = write_section();
+
     load = 0;
     table.clear();
   }
 
+  /// Destroys the elements in place and keeps the memory of the table.
+  /// The worker threads are joined before the write section ends. So,
+  /// optimistic readers retry and never access deallocated memory.
+  template <generic::execution_policy Policy>
+  void clear(Policy&& policy) {
+    const auto section = write_section();
+
+    load = 0;
+    table.clear(policy);
+  }
+
+  /// Maps all pages of the table by touching them in contiguous chunks with
+  /// respect to the given execution policy. Elements are not modified.
+  template <generic::execution_policy Policy>
+  void prefault(Policy&& policy) { table.prefault(policy); }
+
+  /// Swaps the table with an empty table of minimal capacity and destroys the
+  /// old one in parallel on a background thread. The returned future becomes
+  /// ready when all elements have been destroyed and the memory is freed.
+  /// Synchronization policies other than 'unsynchronized' may still have
+  /// optimistic readers on the old table. Then, it is retired instead and
+  /// the returned future is ready right away.
+  auto dispose_async() -> std::future<void> {
+    const auto section = write_section();
+
+    container old{min_capacity, table.get_allocator()};
+    old.swap(table);
+    load = 0;
+    if constexpr (!std::same_as<synchronization, unsynchronized>) {
+      sync.retire(std::move(old));
+      std::promise<void> done{};
+      done.set_value();
+      return done.get_future();
+    }
+    return std::async(std::launch::async, [old = std::move(old)]() mutable {
+      old.clear(execution::par);
+      // Free the memory on this thread and not inside the shared state.
+      const auto trash = std::move(old);
+    });
+  }
+
+  /// Forgets all elements and the memory of the table without destroying and
+  /// deallocating them and starts over with a new table of minimal capacity.
+  constexpr void release() {
+    const auto section = write_section();
+
+    table.release();
+    load  = 0;
+    table = container{min_capacity, table.get_allocator()};
+  }
+
+  auto memory_usage() const noexcept -> robin_hood::memory_usage {
+    auto result     = table.memory_usage();
+    result.elements = load;
+    return result;
+  }
+
+  /// Additionally sums up the bytes owned by the entries
+  /// which are returned by the given function for each of them.
+  template <typename F>
+  auto memory_usage(F&& owned) const -> robin_hood::memory_usage {
+    auto result        = memory_usage();
+    result.owned_bytes = transform_reduce(
+        execution::seq, size_t{0}, std::plus<>{}, std::forward<F>(owned));
+    return result;
+  }
+
+  /// Writes the table layout and the configuration of the container to the
+  /// given stream. Afterwards, the given function is called with the stream
+  /// and the index of every occupied slot in the order of the table to write
+  /// its element. Throws an exception of type 'std::ios_base::failure' if the
+  /// stream fails. @see serialization_header
+  template <typename F>
+  void serialize(std::ostream& os, F&& write) const {
+    using value_type = typename table_value<container>::type;
+    auto header      = serialization_header::make<key_type, value_type>(
+        table.size, load, max_psl());
+    if constexpr (generic::readable_seeded_hasher<hasher>)
+      header.seed = hash.seed;
+    header.psl_bound      = psl_bound;
+    header.max_load_ratio = max_load_ratio;
+    header.min_load_ratio = min_load_ratio;
+    os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    write_psls(os, &table.psl(0), table.size, header.psl_bytes);
+    for (size_type i = 0; i < table.size; ++i)
+      if (!table.empty(i)) write(os, i);
+    if (!os) raise<std::ios_base::failure>("Failed to save table to stream!");
+  }
+
+  /// Replaces the content of the container by the one that has been written
+  /// by 'serialize'. A new table of the stored size is allocated and the given
+  /// function is called with the stream, the new table, and the index of every
+  /// occupied slot to construct its key and value. Hence, no element is hashed
+  /// or swapped. The PSLs are checked for a consistent layout before the table
+  /// is allocated. Only the positions of the first elements are recomputed to
+  /// detect a different hash function. If the stream is invalid, an exception
+  /// of type 'std::invalid_argument' is thrown and the container is unchanged.
+  template <typename F>
+  void deserialize(std::istream& is, F&& read) {
+    using value_type = typename table_value<container>::type;
+    serialization_header header{};
+    is.read(reinterpret_cast<char*>(&header), sizeof(header));
+    const auto expected = serialization_header::make<key_type, value_type>(
+        header.size, header.load, 0);
+    if (!is || (header.magic != expected.magic))
+      raise<std::invalid_argument>(
+          "Failed to load table from stream without table header!");
+    if ((header.key_bytes != expected.key_bytes) ||
+        (header.value_bytes != expected.value_bytes))
+      raise<std::invalid_argument>(
+          "Failed to load table of different element types!");
+    if (((header.psl_bytes != 1) && (header.psl_bytes != sizeof(psl_type))) ||
+        (header.size == 0) || (header.load >= header.size) ||
+        (capacity_policy::round(header.size) != header.size))
+      raise<std::invalid_argument>(
+          "Failed to load table with corrupted layout!");
+    // Comparisons with NaN are false and therefore fail as well.
+    const auto max_ratio = header.max_load_ratio;
+    const auto min_ratio = header.min_load_ratio;
+    if (!((0 < max_ratio) && (max_ratio < 1)) ||
+        !((0 <= min_ratio) && (min_ratio < max_ratio / 4)) ||
+        (header.load > max_ratio * header.size))
+      raise<std::invalid_argument>(
+          "Failed to load table with invalid load factors!");
+
+    std::vector<psl_type> psls{};
+    read_psls(is, psls, header.size, header.psl_bytes);
+    if (!is)
+      raise<std::invalid_argument>(
+          "Failed to load table from truncated stream!");
+    // Lookups and removals rely on PSLs which grow by at most one from slot to
+    // slot. Together with the empty slots ensured by the load, all probe
+    // sequences terminate. Bounded lookups would miss elements beyond the PSL
+    // limit.
+    size_type occupied = 0;
+    for (size_type i = 0; i < header.size; ++i) {
+      const auto psl = psls[i];
+      if ((psl > header.size) ||
+          (psls[probing::next(i, header.size)] > psl + 1))
+        raise<std::invalid_argument>(
+            "Failed to load table with corrupted layout!");
+      if (header.psl_bound && (psl > header.psl_bound))
+        raise<std::invalid_argument>(
+            "Failed to load table whose PSLs exceed its PSL limit!");
+      occupied += (psl != 0);
+    }
+    if (occupied != header.load)
+      raise<std::invalid_argument>(
+          "Failed to load table with corrupted layout!");
+
+    container t{header.size, table.get_allocator()};
+    size_type count = 0;
+    for (size_type i = 0; i < t.size; ++i) {
+      if (!psls[i]) continue;
+      read(is, t, i);
+      t.psl(i) = psls[i];
+      ++count;
+      if (!is)
+        raise<std::invalid_argument>(
+            "Failed to load table from truncated stream!");
+    }
+    if (count != header.load)
+      raise<std::invalid_argument>(
+          "Failed to load table with corrupted layout!");
+
+    const auto section = write_section();
+
+    [[maybe_unused]] const auto old_hash = hash;
+    if constexpr (generic::readable_seeded_hasher<hasher>)
+      hash.reseed(header.seed);
+    if (!placed(t)) {
+      if constexpr (generic::readable_seeded_hasher<hasher>) hash = old_hash;
+      raise<std::invalid_argument>(
+          "Failed to load table written with a different hash function!");
+    }
+    // Hashed keys created before would keep the value of the old seed.
+    if constexpr (generic::readable_seeded_hasher<hasher>)
+      if (hash.seed != old_hash.seed) ++reseeds;
+    table.swap(t);
+    // Optimistic readers may still access the old table.
+    sync.retire(std::move(t));
+    load           = header.load;
+    psl_bound      = header.psl_bound;
+    max_load_ratio = header.max_load_ratio;
+    min_load_ratio = header.min_load_ratio;
+  }
+
+  /// Swaps the elements, functions, and parameters of both containers.
+  /// Old tables retired by the synchronization policies are not exchanged.
+  constexpr void swap(hash_base& other) noexcept {
+    const auto section       = write_section();
+    const auto other_section = other.write_section();
+
+    using std::swap;
+    table.swap(other.table);
+    swap(hash, other.hash);
+    swap(equal, other.equal);
+    swap(load, other.load);
+    swap(max_load_ratio, other.max_load_ratio);
+    swap(min_load_ratio, other.min_load_ratio);
+    swap(reseeds, other.reseeds);
+    swap(psl_bound, other.psl_bound);
+  }
+
+  /// Recomputes the positions of the first occupied slots of the given table
+  /// and checks if they match their probe sequence lengths. A different
+  /// hasher, mixer, or capacity policy would put elements to other positions.
+  constexpr bool placed(const container& t) const {
+    return probing::placed(t, hash);
+  }
+
   static constexpr size_type min_capacity = 8;
 
   container table{min_capacity, allocator{}};
@@ -312,6 +1058,10 @@ struct hash_base {
   equality  equal{};
   size_type load           = 0;
   real      max_load_ratio = 0.8;
+  real      min_load_ratio = 0;
+  size_type reseeds        = 0;
+  psl_type  psl_bound      = 0;
+  [[no_unique_address]] synchronization sync{};
 };
 
 }  // namespace lyrahgames::robin_hood::detail
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+//
+#include <lyrahgames/robin_hood/mapped_file.hpp>
+#include <lyrahgames/robin_hood/meta.hpp>
+//
+#include <lyrahgames/robin_hood/detail/probing.hpp>
+#include <lyrahgames/robin_hood/detail/raise.hpp>
+#include <lyrahgames/robin_hood/detail/traits.hpp>
+
+namespace lyrahgames::robin_hood::detail {
+
+/// Read-only views on tables inside mapped files.
+/// Lookups use the same probing algorithms as 'hash_base'. @see probing
+template <typename Table,
+          typename Hasher,
+          typename Equality,
+          typename Capacity,
+          typename Mixer>
+struct mapped_base {
+  using container       = Table;
+  using key_type        = typename container::key_type;
+  using hasher          = Hasher;
+  using equality        = Equality;
+  using capacity_policy = Capacity;
+  using mixer           = Mixer;
+  using probing         = detail::probing<capacity_policy, mixer>;
+  using real            = double;
+  using size_type       = typename container::size_type;
+  using psl_type        = typename container::psl_type;
+  using const_iterator  = typename container::const_iterator;
+
+  mapped_base() = default;
+
+  /// Maps the given file and checks its header for the given value type.
+  template <typename Value>
+  mapped_base(std::in_place_type_t<Value>,
+              const std::filesystem::path& path,
+              hasher                       h,
+              equality                     e)
+      : file{path}, hash{h}, equal{e} {
+    const auto& header = mapped_file_header::read<key_type, Value>(
+        file.data(), file.size());
+    if (capacity_policy::round(header.size) != header.size)
+      raise<std::invalid_argument>(
+          "Failed to map table whose size violates the capacity policy!");
+    table = container{file.data(), header};
+    load  = header.load;
+    if constexpr (generic::readable_seeded_hasher<hasher>)
+      hash.reseed(header.seed);
+    if (!probing::placed(table, hash))
+      raise<std::invalid_argument>(
+          "Failed to map table written with a different hash function!");
+  }
+
+  /// Does the same as 'hash_base::lookup_data' on the mapped table.
+  auto lookup_data(const key_type& key) const noexcept
+      -> std::tuple<size_type, psl_type, bool> {
+    return probing::lookup_data(table, key, hash(key), equal);
+  }
+
+  bool contains(const key_type& key) const noexcept {
+    const auto [index, psl, found] = lookup_data(key);
+    return found;
+  }
+
+  auto lookup(const key_type& key) const noexcept -> const_iterator {
+    const auto [index, psl, found] = lookup_data(key);
+    if (found) return {&table, index};
+    return table.end();
+  }
+
+  bool empty() const noexcept { return load == 0; }
+
+  auto size() const noexcept { return load; }
+
+  auto capacity() const noexcept { return table.size; }
+
+  auto load_factor() const noexcept { return real(size()) / capacity(); }
+
+  mapped_file file{};
+  container   table{};
+  hasher      hash{};
+  equality    equal{};
+  size_type   load = 0;
+};
+
+}  // namespace lyrahgames::robin_hood::detail
@@ -0,0 +1,89 @@
+#pragma once
+#include <utility>
+//
+#include <lyrahgames/robin_hood/mapped_file.hpp>
+//
+#include <lyrahgames/robin_hood/detail/basic_iterator.hpp>
+#include <lyrahgames/robin_hood/detail/traits.hpp>
+
+namespace lyrahgames::robin_hood::detail {
+
+/// Read-only table of keys whose arrays lie inside a mapped file.
+template <typename Key>
+struct mapped_key_table
+    : public basic_iterator_interface<mapped_key_table<Key>> {
+  using size_type = typename traits::size_type;
+  using psl_type  = typename traits::psl_type;
+  using key_type  = Key;
+  using header    = mapped_file_header;
+
+  mapped_key_table() = default;
+
+  /// Points the arrays into the given mapping.
+  /// Assumes the header has already been checked.
+  mapped_key_table(const std::byte* data, const header& h) noexcept
+      : size{h.size},
+        psls{reinterpret_cast<const psl_type*>(data + h.psl_offset)},
+        keys{reinterpret_cast<const key_type*>(data + h.key_offset)} {}
+
+  bool empty(size_type index) const noexcept { return psls[index] == 0; }
+
+  auto entry(size_type index) const noexcept -> const key_type& {
+    return keys[index];
+  }
+
+  auto psl(size_type index) const noexcept -> psl_type { return psls[index]; }
+
+  auto key(size_type index) const noexcept -> const key_type& {
+    return keys[index];
+  }
+
+  size_type       size = 0;
+  const psl_type* psls = nullptr;
+  const key_type* keys = nullptr;
+};
+
+/// Read-only table of keys and values whose arrays lie inside a mapped file.
+template <typename Key, typename Value>
+struct mapped_key_value_table
+    : public basic_iterator_interface<mapped_key_value_table<Key, Value>> {
+  using size_type  = typename traits::size_type;
+  using psl_type   = typename traits::psl_type;
+  using key_type   = Key;
+  using value_type = Value;
+  using header     = mapped_file_header;
+
+  mapped_key_value_table() = default;
+
+  /// Points the arrays into the given mapping.
+  /// Assumes the header has already been checked.
+  mapped_key_value_table(const std::byte* data, const header& h) noexcept
+      : size{h.size},
+        psls{reinterpret_cast<const psl_type*>(data + h.psl_offset)},
+        keys{reinterpret_cast<const key_type*>(data + h.key_offset)},
+        values{reinterpret_cast<const value_type*>(data + h.value_offset)} {}
+
+  bool empty(size_type index) const noexcept { return psls[index] == 0; }
+
+  auto entry(size_type index) const noexcept {
+    return std::pair<const key_type&, const value_type&>{keys[index],
+                                                         values[index]};
+  }
+
+  auto psl(size_type index) const noexcept -> psl_type { return psls[index]; }
+
+  auto key(size_type index) const noexcept -> const key_type& {
+    return keys[index];
+  }
+
+  auto value(size_type index) const noexcept -> const value_type& {
+    return values[index];
+  }
+
+  size_type         size   = 0;
+  const psl_type*   psls   = nullptr;
+  const key_type*   keys   = nullptr;
+  const value_type* values = nullptr;
+};
+
+}  // namespace lyrahgames::robin_hood::detail
@@ -0,0 +1,93 @@
+#pragma once
+#include <cerrno>
+#include <cstddef>
+#include <system_error>
+#include <utility>
+//
+#if !defined(__linux__)
+#error "Memory mappings are only available on Linux."
+#endif
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+//
+#include <lyrahgames/robin_hood/detail/raise.hpp>
+
+namespace lyrahgames::robin_hood::detail {
+
+/// Shared mapping of a whole file or shared-memory object which is unmapped
+/// on destruction. Both 'mapped_file' and 'shared_memory' build on it.
+class memory_mapping {
+ public:
+  memory_mapping() = default;
+
+  /// Maps the object of the given descriptor with its current size. The
+  /// descriptor is closed in any case. The mapping stays valid afterwards.
+  /// Throws an exception of type 'std::system_error' on failure.
+  memory_mapping(int fd, bool writable) {
+    struct stat info {};
+    if (::fstat(fd, &info) < 0)
+      fail(fd, "Failed to determine size of mapped object!");
+    map(fd, info.st_size, writable);
+  }
+
+  /// Resizes the object of the given descriptor to the given count of bytes
+  /// before mapping it. New bytes are zero. @see memory_mapping(int, bool)
+  memory_mapping(int fd, size_t size, bool writable) {
+    if (::ftruncate(fd, size) < 0) fail(fd, "Failed to resize mapped object!");
+    map(fd, size, writable);
+  }
+
+  ~memory_mapping() noexcept {
+    if (memory) ::munmap(memory, bytes);
+  }
+
+  memory_mapping(memory_mapping&& m) noexcept
+      : memory{std::exchange(m.memory, nullptr)},
+        bytes{std::exchange(m.bytes, 0)} {}
+
+  memory_mapping& operator=(memory_mapping&& m) noexcept {
+    std::swap(memory, m.memory);
+    std::swap(bytes, m.bytes);
+    return *this;
+  }
+
+  memory_mapping(const memory_mapping&) = delete;
+  memory_mapping& operator=(const memory_mapping&) = delete;
+
+  auto data() noexcept { return memory; }
+
+  auto data() const noexcept -> const std::byte* { return memory; }
+
+  auto size() const noexcept { return bytes; }
+
+  /// Throws an exception of type 'std::system_error' for the current 'errno'.
+  [[noreturn]] static void fail(const char* message) {
+    raise<std::system_error>(errno, std::generic_category(), message);
+  }
+
+ private:
+  void map(int fd, size_t size, bool writable) {
+    if (size) {
+      const auto protection = PROT_READ | (writable ? PROT_WRITE : 0);
+      const auto p = ::mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+      if (p == MAP_FAILED) fail(fd, "Failed to map object!");
+      memory = static_cast<std::byte*>(p);
+      bytes  = size;
+    }
+    // The mapping stays valid after the descriptor has been closed.
+    ::close(fd);
+  }
+
+  /// Closes the given descriptor without losing the current 'errno'.
+  [[noreturn]] static void fail(int fd, const char* message) {
+    const auto error = errno;
+    ::close(fd);
+    raise<std::system_error>(error, std::generic_category(), message);
+  }
+
+  std::byte* memory = nullptr;
+  size_t     bytes  = 0;
+};
+
+}  // namespace lyrahgames::robin_hood::detail
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+
+namespace lyrahgames::robin_hood::detail {
+
+/// Returns the low and the high half of the full product of the given numbers.
+constexpr auto multiply(uint64_t x, uint64_t y) noexcept
+    -> std::pair<uint64_t, uint64_t> {
+#if defined(__SIZEOF_INT128__)
+  const auto r = (unsigned __int128)(x)*y;
+  return {uint64_t(r), uint64_t(r >> 64)};
+#else
+  const auto x_low  = x & 0xffffffff;
+  const auto x_high = x >> 32;
+  const auto y_low  = y & 0xffffffff;
+  const auto y_high = y >> 32;
+  const auto low    = x_low * y_low;
+  const auto mid1   = x_high * y_low + (low >> 32);
+  const auto mid2   = x_low * y_high + (mid1 & 0xffffffff);
+  return {x * y, x_high * y_high + (mid1 >> 32) + (mid2 >> 32)};
+#endif
+}
+
+}  // namespace lyrahgames::robin_hood::detail
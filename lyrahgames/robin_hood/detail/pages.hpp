@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace lyrahgames::robin_hood::detail {
+
+struct pages {
+  /// Smallest page size of common platforms. Larger pages are only touched
+  /// more often than necessary, which is harmless.
+  static constexpr size_t size = 4096;
+
+  /// Touches the pages of the elements [first, last) of the given array such
+  /// that the operating system maps them before they are used. The content is
+  /// kept. To be able to touch disjoint ranges of the same array concurrently,
+  /// only pages starting inside the range are touched. The first page of the
+  /// array is touched by the range beginning with the first element.
+  template <typename T>
+  static void touch(T* data, size_t first, size_t last) noexcept {
+    if (first == last) return;
+    const auto begin   = reinterpret_cast<std::uintptr_t>(data + first);
+    const auto end     = reinterpret_cast<std::uintptr_t>(data + last);
+    auto       address = (begin + size - 1) & ~std::uintptr_t(size - 1);
+    if ((first == 0) && (address != begin)) touch(begin);
+    for (; address < end; address += size)
+      touch(address);
+  }
+
+  /// Writes back the byte at the given address.
+  static void touch(std::uintptr_t address) noexcept {
+    const auto p = reinterpret_cast<volatile unsigned char*>(address);
+    *p           = *p;
+  }
+};
+
+}  // namespace lyrahgames::robin_hood::detail
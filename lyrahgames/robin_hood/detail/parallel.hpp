@@ -0,0 +1,78 @@
+#pragma once
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <type_traits>
+#include <vector>
+//
+#include <lyrahgames/robin_hood/execution.hpp>
+//
+#include <lyrahgames/robin_hood/detail/raise.hpp>
+#include <lyrahgames/robin_hood/detail/traits.hpp>
+
+namespace lyrahgames::robin_hood::detail {
+
+struct parallel {
+  using size_type = typename traits::size_type;
+
+  /// Smallest count of table slots worth to be processed by its own thread.
+  static constexpr size_type min_chunk_size = size_type{1} << 14;
+
+  /// Returns the count of contiguous chunks a table with the given size is
+  /// divided into when it is processed with the given execution policy.
+  template <generic::execution_policy Policy>
+  static auto chunk_count(size_type size) noexcept -> size_type {
+    using policy = std::remove_cvref_t<Policy>;
+    if constexpr (std::is_same_v<policy, execution::sequenced_policy>) {
+      return 1;
+    } else {
+      const auto threads = std::max(
+          size_type{1}, size_type(std::thread::hardware_concurrency()));
+      return std::clamp(size / min_chunk_size, size_type{1}, threads);
+    }
+  }
+
+  /// Divides the index range [0, size) into the given count of contiguous
+  /// chunks and calls 'f(chunk, first, last)' for each of them on its own
+  /// thread. The calling thread processes the last chunk. The first exception
+  /// thrown by 'f' is rethrown after all threads have been joined.
+  template <typename F>
+  static void for_each_chunk(size_type count, size_type size, F&& f) {
+    const auto chunk = size / count;
+    const auto run   = [&](size_type i) {
+      const auto first = i * chunk;
+      const auto last  = (i + 1 == count) ? size : first + chunk;
+      f(i, first, last);
+    };
+    if (count == 1) {
+      run(0);
+      return;
+    }
+
+    std::vector<std::exception_ptr> errors(count);
+    const auto                      guarded = [&](size_type i) {
+      LYRAHGAMES_ROBIN_HOOD_TRY { run(i); }
+      LYRAHGAMES_ROBIN_HOOD_CATCH { errors[i] = std::current_exception(); }
+    };
+    {
+      // Joining threads make sure that no thread outlives the given function,
+      // even if spawning one of them fails.
+      std::vector<std::jthread> threads{};
+      threads.reserve(count - 1);
+      for (size_type i = 0; i < count - 1; ++i)
+        threads.emplace_back(guarded, i);
+      guarded(count - 1);
+    }
+    for (const auto& e : errors)
+      if (e) std::rethrow_exception(e);
+  }
+
+  /// Calls 'f(chunk, first, last)' for all chunks of a table with the given
+  /// size with respect to the given execution policy. @see chunk_count
+  template <generic::execution_policy Policy, typename F>
+  static void for_each_chunk(Policy&&, size_type size, F&& f) {
+    for_each_chunk(chunk_count<Policy>(size), size, std::forward<F>(f));
+  }
+};
+
+}  // namespace lyrahgames::robin_hood::detail
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <tuple>
+//
+#include <lyrahgames/robin_hood/detail/traits.hpp>
+
+namespace lyrahgames::robin_hood::detail {
+
+/// Read-only probing algorithms of Robin Hood tables. The flat containers and
+/// the views on mapped and shared tables all use them. So, the views find the
+/// elements at exactly the positions the containers have put them. Tables
+/// only need to provide 'size', 'psl(index)', and 'key(index)'.
+template <typename Capacity, typename Mixer>
+struct probing {
+  using size_type       = typename traits::size_type;
+  using psl_type        = typename traits::psl_type;
+  using capacity_policy = Capacity;
+  using mixer           = Mixer;
+
+  /// Count of occupied slots whose positions are checked by 'placed'.
+  static constexpr size_type checked_slots = 64;
+
+  /// Returns the ideal index of a key with the given value of the hasher
+  /// for a table with the given size.
+  static constexpr auto index(size_t h, size_type size) noexcept -> size_type {
+    const auto m = mixer::mix(h);
+    if constexpr (mixer::high_bits)
+      return capacity_policy::high_index(m, size);
+    else
+      return capacity_policy::index(m, size);
+  }
+
+  /// Advance the given index to a table with the given size by one.
+  static constexpr auto next(size_type index, size_type size) noexcept
+      -> size_type {
+    return capacity_policy::next(index, size);
+  }
+
+  /// If the key with the given value of the hasher is contained in the table
+  /// then this function returns its index, probe sequence length, and 'true'.
+  /// Otherwise, it would return the index where it would have to be inserted
+  /// with the according probe sequence length and 'false'.
+  template <typename Table, typename Key, typename Equality>
+  static constexpr auto lookup_data(const Table&    t,
+                                    const Key&      key,
+                                    size_t          h,
+                                    const Equality& equal) noexcept
+      -> std::tuple<size_type, psl_type, bool> {
+    auto i   = index(h, t.size);
+    auto psl = psl_type{1};
+    for (; psl < t.psl(i); ++psl)
+      i = next(i, t.size);
+    for (; psl == t.psl(i); ++psl) {
+      if (equal(t.key(i), key)) return {i, psl, true};
+      i = next(i, t.size);
+    }
+    return {i, psl, false};
+  }
+
+  /// A different hasher, mixer, or capacity policy would put elements to
+  /// other positions and lookups would silently fail. To detect this, the
+  /// positions of the first occupied slots of the table are recomputed.
+  template <typename Table, typename Hasher>
+  static constexpr bool placed(const Table& t, const Hasher& hash) {
+    size_type checked = 0;
+    for (size_type i = 0; (i < t.size) && (checked < checked_slots); ++i) {
+      if (!t.psl(i)) continue;
+      ++checked;
+      auto j = index(hash(t.key(i)), t.size);
+      for (psl_type psl = 1; psl < t.psl(i); ++psl)
+        j = next(j, t.size);
+      if (j != i) return false;
+    }
+    return true;
+  }
+};
+
+}  // namespace lyrahgames::robin_hood::detail
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+
+// Exceptions may be disabled, e.g. by '-fno-exceptions'. In this case, every
+// error aborts the process and cleanup code that would only run before
+// rethrowing an exception is left out.
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+#define LYRAHGAMES_ROBIN_HOOD_EXCEPTIONS 1
+#define LYRAHGAMES_ROBIN_HOOD_TRY try
+#define LYRAHGAMES_ROBIN_HOOD_CATCH catch (...)
+#define LYRAHGAMES_ROBIN_HOOD_RETHROW throw
+#else
+#define LYRAHGAMES_ROBIN_HOOD_EXCEPTIONS 0
+#define LYRAHGAMES_ROBIN_HOOD_TRY if constexpr (true)
+#define LYRAHGAMES_ROBIN_HOOD_CATCH else
+#define LYRAHGAMES_ROBIN_HOOD_RETHROW static_cast<void>(0)
+#endif
+
+namespace lyrahgames::robin_hood::detail {
+
+inline void print_error(const char* message) noexcept {
+  std::fprintf(stderr, "%s\n", message);
+}
+
+template <typename T>
+constexpr void print_error(const T&) noexcept {}
+
+/// Throws an exception of the given type constructed from the given
+/// arguments. Without exceptions, messages given as arguments are printed
+/// to the standard error stream and the process is aborted.
+template <typename Exception, typename... Arguments>
+[[noreturn]] constexpr void raise(Arguments&&... args) {
+#if LYRAHGAMES_ROBIN_HOOD_EXCEPTIONS
+  throw Exception(std::forward<Arguments>(args)...);
+#else
+  (print_error(args), ...);
+  std::abort();
+#endif
+}
+
+}  // namespace lyrahgames::robin_hood::detail
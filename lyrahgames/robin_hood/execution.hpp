@@ -0,0 +1,34 @@
+#pragma once
+#include <concepts>
+#include <type_traits>
+
+namespace lyrahgames::robin_hood {
+
+/// Execution policies for the parallel algorithms of the flat containers.
+/// We do not use the policies of '<execution>' because, with some standard
+/// library implementations, including the header alone requires linking
+/// against an additional threading library.
+namespace execution {
+
+/// The algorithm runs on the calling thread.
+struct sequenced_policy {};
+
+/// The algorithm divides the table into contiguous chunks of slots and
+/// processes them on multiple threads.
+struct parallel_policy {};
+
+inline constexpr sequenced_policy seq{};
+inline constexpr parallel_policy  par{};
+
+}  // namespace execution
+
+namespace generic {
+
+template <typename T>
+concept execution_policy =
+    std::same_as<std::remove_cvref_t<T>, execution::sequenced_policy> ||
+    std::same_as<std::remove_cvref_t<T>, execution::parallel_policy>;
+
+}  // namespace generic
+
+}  // namespace lyrahgames::robin_hood
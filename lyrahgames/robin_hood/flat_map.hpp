@@ -1,5 +1,16 @@
 #pragma once
+#include <functional>
+#include <future>
+#include <optional>
+#include <type_traits>
+//
+#include <lyrahgames/robin_hood/capacity.hpp>
+#include <lyrahgames/robin_hood/hashed_key.hpp>
+#include <lyrahgames/robin_hood/insert_status.hpp>
 #include <lyrahgames/robin_hood/meta.hpp>
+#include <lyrahgames/robin_hood/mixer.hpp>
+#include <lyrahgames/robin_hood/prefault.hpp>
+#include <lyrahgames/robin_hood/synchronization.hpp>
 //
 #include <lyrahgames/robin_hood/detail/flat_key_value_table.hpp>
 #include <lyrahgames/robin_hood/detail/hash_base.hpp>
@@ -10,143 +21,188 @@ template <generic::key                       Key,
           generic::value                     Value,
           generic::hasher<Key>               Hasher    = std::hash<Key>,
           generic::equivalence_relation<Key> Equality  = std::equal_to<Key>,
-          generic::allocator                 Allocator = std::allocator<Key>>
+          generic::allocator                 Allocator = std::allocator<Key>,
+          typename Synchronization = unsynchronized,
+          typename Capacity        = power_of_two_capacity,
+          typename Mixer           = default_mixer<Capacity>>
 class flat_map;
 
-#define TEMPLATE                                         \
-  template <generic::key Key, generic::value Value,      \
-            generic::hasher<Key>               Hasher,   \
-            generic::equivalence_relation<Key> Equality, \
-            generic::allocator                 Allocator>
-#define FLAT_MAP flat_map<Key, Value, Hasher, Equality, Allocator>
+#define TEMPLATE                                                \
+  template <generic::key Key, generic::value Value,             \
+            generic::hasher<Key>               Hasher,          \
+            generic::equivalence_relation<Key> Equality,        \
+            generic::allocator                 Allocator,       \
+            typename                           Synchronization, \
+            typename                           Capacity,        \
+            typename                           Mixer>
+#define FLAT_MAP                                                     \
+  flat_map<Key, Value, Hasher, Equality, Allocator, Synchronization, \
+           Capacity, Mixer>
 
 TEMPLATE
 using flat_map_base =
     detail::hash_base<detail::flat_key_value_table<Key, Value, Allocator>,
                       Hasher,
-                      Equality>;
+                      Equality,
+                      Synchronization,
+                      Capacity,
+                      Mixer>;
 
 TEMPLATE
-class flat_map
-    : private flat_map_base<Key, Value, Hasher, Equality, Allocator> {
+class flat_map : private flat_map_base<Key,
+                                       Value,
+                                       Hasher,
+                                       Equality,
+                                       Allocator,
+                                       Synchronization,
+                                       Capacity,
+                                       Mixer> {
  public:
-  using base           = flat_map_base<Key, Value, Hasher, Equality, Allocator>;
-  using key_type       = Key;
-  using mapped_type    = Value;
-  using allocator      = Allocator;
-  using hasher         = Hasher;
-  using equality       = Equality;
-  using size_type      = typename base::size_type;
-  using real           = typename base::real;
-  using const_iterator = typename base::const_iterator;
-  using iterator       = typename base::iterator;
+  using base = flat_map_base<Key,
+                             Value,
+                             Hasher,
+                             Equality,
+                             Allocator,
+                             Synchronization,
+                             Capacity,
+                             Mixer>;
+  using key_type        = Key;
+  using mapped_type     = Value;
+  using allocator       = Allocator;
+  using hasher          = Hasher;
+  using equality        = Equality;
+  using synchronization = Synchronization;
+  using capacity_policy = Capacity;
+  using mixer           = Mixer;
+  using size_type       = typename base::size_type;
+  using psl_type        = typename base::psl_type;
+  using real            = typename base::real;
+  using const_iterator  = typename base::const_iterator;
+  using iterator        = typename base::iterator;
 
   /// Used for statistics and logging tests.
   using base::lookup_data;
 
   flat_map() = default;
 
-  flat_map(size_type s,
-           real      m,
-           hasher    h = {},
-           equality  e = {},
-           allocator a = {})
+  /// Copies the given map by copy constructing its elements in contiguous
+  /// chunks of slots with respect to the given execution policy.
+  template <generic::execution_policy Policy>
+  flat_map(Policy&& policy, const flat_map& other) : base(policy, other) {}
+
+  constexpr flat_map(size_type s,
+                     real      m,
+                     hasher    h = {},
+                     equality  e = {},
+                     allocator a = {})
       : base(s, m, h, e, a) {}
 
-  flat_map(size_type s, real m, allocator a)
+  constexpr flat_map(size_type s, real m, allocator a)
       : flat_map(s, m, hasher{}, equality{}, a) {}
 
-  flat_map(size_type s, real m, hasher h, allocator a)
+  constexpr flat_map(size_type s, real m, hasher h, allocator a)
       : flat_map(s, m, h, equality{}, a) {}
 
-  explicit flat_map(size_type s,
-                    hasher    h = {},
-                    equality  e = {},
-                    allocator a = {})
+  constexpr explicit flat_map(size_type s,
+                              hasher    h = {},
+                              equality  e = {},
+                              allocator a = {})
       : base(s, h, e, a) {}
 
-  flat_map(size_type s, allocator a) : flat_map(s, hasher{}, equality{}, a) {}
+  constexpr flat_map(size_type s, allocator a)
+      : flat_map(s, hasher{}, equality{}, a) {}
 
-  flat_map(size_type s, hasher h, allocator a)
+  constexpr flat_map(size_type s, hasher h, allocator a)
       : flat_map(s, h, equality{}, a) {}
 
+  /// Reserves memory for the given count of elements and prefaults it.
+  /// @see prefault
+  flat_map(prefault_t,
+          size_type s,
+          hasher    h = {},
+          equality  e = {},
+          allocator a = {})
+      : flat_map(s, h, e, a) {
+    prefault();
+  }
+
   template <generic::pair_input_range<key_type, mapped_type> T>
-  explicit flat_map(const T&  data,
-                    hasher    h = {},
-                    equality  e = {},
-                    allocator a = {})
+  constexpr explicit flat_map(const T&  data,
+                              hasher    h = {},
+                              equality  e = {},
+                              allocator a = {})
       : flat_map(std::ranges::size(data), h, e, a) {
     for (const auto& [k, v] : data)
       nocheck_static_insert_or_assign(k, v);
   }
 
   template <generic::pair_input_range<key_type, mapped_type> T>
-  flat_map(const T& data, allocator a)
+  constexpr flat_map(const T& data, allocator a)
       : flat_map(data, hasher{}, equality{}, a) {}
 
   template <generic::pair_input_range<key_type, mapped_type> T>
-  flat_map(const T& data, hasher h, allocator a)
+  constexpr flat_map(const T& data, hasher h, allocator a)
       : flat_map(data, h, equality{}, a) {}
 
   template <generic::pair_input_range<key_type, mapped_type> T>
-  flat_map(const T&  data,
-           real      m,
-           hasher    h = {},
-           equality  e = {},
-           allocator a = {})
+  constexpr flat_map(const T&  data,
+                     real      m,
+                     hasher    h = {},
+                     equality  e = {},
+                     allocator a = {})
       : flat_map(std::ranges::size(data), m, h, e, a) {
     for (const auto& [k, v] : data)
       nocheck_static_insert_or_assign(k, v);
   }
 
   template <generic::pair_input_range<key_type, mapped_type> T>
-  flat_map(const T& data, real m, allocator a)
+  constexpr flat_map(const T& data, real m, allocator a)
       : flat_map(data, m, hasher{}, equality{}, a) {}
 
   template <generic::pair_input_range<key_type, mapped_type> T>
-  flat_map(const T& data, real m, hasher h, allocator a)
+  constexpr flat_map(const T& data, real m, hasher h, allocator a)
       : flat_map(data, m, h, equality{}, a) {}
 
   template <generic::pair_input_range<key_type, mapped_type> T>
-  flat_map(const T&  data,
-           size_type s,
-           real      m,
-           hasher    h = {},
-           equality  e = {},
-           allocator a = {})
+  constexpr flat_map(const T&  data,
+                     size_type s,
+                     real      m,
+                     hasher    h = {},
+                     equality  e = {},
+                     allocator a = {})
       : flat_map(std::max(std::ranges::size(data), s), m, h, e, a) {
     for (const auto& [k, v] : data)
       nocheck_static_insert_or_assign(k, v);
   }
 
   template <generic::pair_input_range<key_type, mapped_type> T>
-  flat_map(const T& data, size_type s, real m, allocator a)
+  constexpr flat_map(const T& data, size_type s, real m, allocator a)
       : flat_map(data, s, m, hasher{}, equality{}, a) {}
 
   template <generic::pair_input_range<key_type, mapped_type> T>
-  flat_map(const T& data, size_type s, real m, hasher h, allocator a)
+  constexpr flat_map(const T& data, size_type s, real m, hasher h, allocator a)
       : flat_map(data, s, m, h, equality{}, a) {}
 
   template <generic::pair_input_range<key_type, mapped_type> T>
-  flat_map(const T&  data,
-           size_type s,
-           hasher    h = {},
-           equality  e = {},
-           allocator a = {})
+  constexpr flat_map(const T&  data,
+                     size_type s,
+                     hasher    h = {},
+                     equality  e = {},
+                     allocator a = {})
       : flat_map(std::max(s, std::ranges::size(data)), h, e, a) {
     for (const auto& [k, v] : data)
       nocheck_static_insert_or_assign(k, v);
   }
 
   template <generic::pair_input_range<key_type, mapped_type> T>
-  flat_map(const T& data, size_type s, allocator a)
+  constexpr flat_map(const T& data, size_type s, allocator a)
       : flat_map(data, s, hasher{}, equality{}, a) {}
 
   template <generic::pair_input_range<key_type, mapped_type> T>
-  flat_map(const T& data, size_type s, hasher h, allocator a)
+  constexpr flat_map(const T& data, size_type s, hasher h, allocator a)
       : flat_map(data, s, h, equality{}, a) {}
 
-  explicit flat_map(
+  constexpr explicit flat_map(
       std::initializer_list<std::pair<key_type, mapped_type>> list,
       hasher                                                  h = {},
       equality                                                e = {},
@@ -156,151 +212,281 @@ class flat_map
       nocheck_static_insert_or_assign(k, v);
   }
 
-  flat_map(std::initializer_list<std::pair<key_type, mapped_type>> list,
-           allocator                                               a)
+  constexpr flat_map(
+      std::initializer_list<std::pair<key_type, mapped_type>> list,
+      allocator                                               a)
       : flat_map(list, hasher{}, equality{}, a) {}
 
-  flat_map(std::initializer_list<std::pair<key_type, mapped_type>> list,
-           hasher                                                  h,
-           allocator                                               a)
+  constexpr flat_map(
+      std::initializer_list<std::pair<key_type, mapped_type>> list,
+      hasher                                                  h,
+      allocator                                               a)
       : flat_map(list, h, equality{}, a) {}
 
-  flat_map(std::initializer_list<std::pair<key_type, mapped_type>> list,
-           size_type                                               s,
-           hasher                                                  h = {},
-           equality                                                e = {},
-           allocator                                               a = {})
+  constexpr flat_map(
+      std::initializer_list<std::pair<key_type, mapped_type>> list,
+      size_type                                               s,
+      hasher                                                  h = {},
+      equality                                                e = {},
+      allocator                                               a = {})
       : flat_map(std::max(s, std::ranges::size(list)), h, e, a) {
     for (const auto& [k, v] : list)
       nocheck_static_insert_or_assign(k, v);
   }
 
-  flat_map(std::initializer_list<std::pair<key_type, mapped_type>> list,
-           size_type                                               s,
-           allocator                                               a)
+  constexpr flat_map(
+      std::initializer_list<std::pair<key_type, mapped_type>> list,
+      size_type                                               s,
+      allocator                                               a)
       : flat_map(list, s, hasher{}, equality{}, a) {}
 
-  flat_map(std::initializer_list<std::pair<key_type, mapped_type>> list,
-           size_type                                               s,
-           hasher                                                  h,
-           allocator                                               a)
+  constexpr flat_map(
+      std::initializer_list<std::pair<key_type, mapped_type>> list,
+      size_type                                               s,
+      hasher                                                  h,
+      allocator                                               a)
       : flat_map(list, s, h, equality{}, a) {}
 
-  flat_map(std::initializer_list<std::pair<key_type, mapped_type>> list,
-           real                                                    m,
-           hasher                                                  h = {},
-           equality                                                e = {},
-           allocator                                               a = {})
+  constexpr flat_map(
+      std::initializer_list<std::pair<key_type, mapped_type>> list,
+      real                                                    m,
+      hasher                                                  h = {},
+      equality                                                e = {},
+      allocator                                               a = {})
       : flat_map(std::ranges::size(list), m, h, e, a) {
     for (const auto& [k, v] : list)
       nocheck_static_insert_or_assign(k, v);
   }
 
-  flat_map(std::initializer_list<std::pair<key_type, mapped_type>> list,
-           real                                                    m,
-           allocator                                               a)
+  constexpr flat_map(
+      std::initializer_list<std::pair<key_type, mapped_type>> list,
+      real                                                    m,
+      allocator                                               a)
       : flat_map(list, m, hasher{}, equality{}, a) {}
 
-  flat_map(std::initializer_list<std::pair<key_type, mapped_type>> list,
-           real                                                    m,
-           hasher                                                  h,
-           allocator                                               a)
+  constexpr flat_map(
+      std::initializer_list<std::pair<key_type, mapped_type>> list,
+      real                                                    m,
+      hasher                                                  h,
+      allocator                                               a)
       : flat_map(list, m, h, equality{}, a) {}
 
-  flat_map(std::initializer_list<std::pair<key_type, mapped_type>> list,
-           size_type                                               s,
-           real                                                    m,
-           hasher                                                  h = {},
-           equality                                                e = {},
-           allocator                                               a = {})
+  constexpr flat_map(
+      std::initializer_list<std::pair<key_type, mapped_type>> list,
+      size_type                                               s,
+      real                                                    m,
+      hasher                                                  h = {},
+      equality                                                e = {},
+      allocator                                               a = {})
       : flat_map(std::max(s, std::ranges::size(list)), m, h, e, a) {
     for (const auto& [k, v] : list)
       nocheck_static_insert_or_assign(k, v);
   }
 
-  flat_map(std::initializer_list<std::pair<key_type, mapped_type>> list,
-           size_type                                               s,
-           real                                                    m,
-           allocator                                               a)
+  constexpr flat_map(
+      std::initializer_list<std::pair<key_type, mapped_type>> list,
+      size_type                                               s,
+      real                                                    m,
+      allocator                                               a)
       : flat_map(list, s, m, hasher{}, equality{}, a) {}
 
-  flat_map(std::initializer_list<std::pair<key_type, mapped_type>> list,
-           size_type                                               s,
-           real                                                    m,
-           hasher                                                  h,
-           allocator                                               a)
+  constexpr flat_map(
+      std::initializer_list<std::pair<key_type, mapped_type>> list,
+      size_type                                               s,
+      real                                                    m,
+      hasher                                                  h,
+      allocator                                               a)
       : flat_map(list, s, m, h, equality{}, a) {}
 
   /// Checks if the map contains zero elements.
-  bool empty() const noexcept { return base::empty(); }
+  constexpr bool empty() const noexcept { return base::empty(); }
 
   /// Returns the count of inserted elements.
-  auto size() const noexcept { return base::size(); }
+  constexpr auto size() const noexcept { return base::size(); }
 
   /// Returns the maximum number of storable elements in the current table.
   /// The capacity is doubled when the the load factor exceeds
   /// the maximum load factor.
-  auto capacity() const noexcept { return base::capacity(); }
+  constexpr auto capacity() const noexcept { return base::capacity(); }
 
   /// Returns the current load factor of the map.
   /// The load factor is the quotient of size and capacity.
-  auto load_factor() const noexcept { return base::load_factor(); }
+  constexpr auto load_factor() const noexcept { return base::load_factor(); }
 
   /// Returns the maximum load factor the map is allowed to have before
   /// rehashing all elements with a bigger capacity.
-  auto max_load_factor() const noexcept { return base::max_load_factor(); }
+  constexpr auto max_load_factor() const noexcept {
+    return base::max_load_factor();
+  }
 
   /// Sets the maximum load factor the map is allowed to have before
   /// rehashing all elements with a bigger capacity.
   /// Setting the maximum load factor to smaller values, may trigger a
   /// reallocation and rehashing of all contained values.
-  void set_max_load_factor(real x) { base::set_max_load_factor(x); }
+  constexpr void set_max_load_factor(real x) { base::set_max_load_factor(x); }
+
+  /// Returns the minimum load factor below which the map is shrunk after
+  /// removing an element by its key. Zero means no automatic shrinking.
+  constexpr auto min_load_factor() const noexcept {
+    return base::min_load_factor();
+  }
+
+  /// Sets the minimum load factor for automatic shrinking. It has to be less
+  /// than a quarter of the maximum load factor. This margin prevents the map
+  /// from thrashing between growing and shrinking. Removing elements through
+  /// iterators never shrinks the map to keep other iterators valid.
+  constexpr void set_min_load_factor(real x) { base::set_min_load_factor(x); }
+
+  /// Returns a constant reference to the hasher, e.g. to read its seed.
+  constexpr const auto& hash_function() const noexcept { return base::hash; }
+
+  /// Returns how often the seed of the hasher has been replaced, either by
+  /// calling 'reseed', by loading a table with another seed, or automatically
+  /// because of detected hash flooding.
+  /// @see seeded_hash
+  constexpr auto reseed_count() const noexcept { return base::reseed_count(); }
+
+  /// Replaces the seed of the hasher by a new random seed and rehashes all
+  /// elements. In this case, all iterators and pointers become invalid.
+  constexpr void reseed() requires generic::seeded_hasher<hasher> {
+    base::reseed_and_rehash();
+  }
+
+  /// Returns the maximal probe sequence length of elements in the map or zero
+  /// if it is unbounded. @see set_psl_limit
+  constexpr auto psl_limit() const noexcept { return base::psl_limit(); }
+
+  /// Bounds the probe sequence length of all elements by the given value.
+  /// Insertions that would exceed the limit reseed the hasher or grow the
+  /// table instead. This way, every lookup inspects at most the given count of
+  /// slots. Zero removes the bound. Throws 'std::overflow_error' if the limit
+  /// cannot be kept without wasting memory, e.g. for too many equal hashes.
+  constexpr void set_psl_limit(psl_type x) { base::set_psl_limit(x); }
+
+  /// Returns the largest probe sequence length of all elements.
+  constexpr auto max_psl() const noexcept { return base::max_psl(); }
 
   /// Return an iterator to the beginning of the map.
-  auto begin() noexcept -> iterator { return base::table.begin(); }
+  constexpr auto begin() noexcept -> iterator { return base::table.begin(); }
 
   /// Return a constant iterator to the beginning of the map.
-  auto begin() const noexcept -> const_iterator { return base::table.begin(); }
+  constexpr auto begin() const noexcept -> const_iterator {
+    return base::table.begin();
+  }
 
   /// Return an iterator to the end of the map.
-  auto end() noexcept -> iterator { return base::table.end(); }
+  constexpr auto end() noexcept -> iterator { return base::table.end(); }
 
   /// Return a constant iterator to the end of the map.
-  auto end() const noexcept -> const_iterator { return base::table.end(); }
+  constexpr auto end() const noexcept -> const_iterator {
+    return base::table.end();
+  }
 
   /// Returns a constant reference to the underlying table.
   /// Mainly used for debugging and logging.
-  const auto& data() const noexcept { return base::table; }
+  constexpr const auto& data() const noexcept { return base::table; }
 
   /// Checks if an element with given key has already
   /// been inserted into the map.
-  bool contains(const key_type& key) const noexcept {
+  constexpr bool contains(const key_type& key) const noexcept {
     return base::contains(key);
   }
 
   /// Creates an iterator pointing to an element with the given key.
   /// If this is not possible, returns the end iterator.
-  auto lookup(const key_type& key) noexcept -> iterator {
+  constexpr auto lookup(const key_type& key) noexcept -> iterator {
     return base::lookup(key);
   }
 
   /// Creates a constant iterator pointing to an element with the given key.
   /// If this is not possible, return the end iterator. @see lookup
-  auto lookup(const key_type& key) const noexcept -> const_iterator {
+  constexpr auto lookup(const key_type& key) const noexcept -> const_iterator {
     return base::lookup(key);
   }
 
+  /// Returns the given key together with the value of the hasher for it.
+  /// The overloads taking such a key do not call the hasher. @see hashed_key
+  constexpr auto hashed(const key_type& key) const noexcept
+      -> hashed_key<key_type> {
+    return base::hashed(key);
+  }
+
+  /// The returned reference to a temporary key would dangle.
+  void hashed(key_type&&) const = delete;
+
+  /// Does the same as 'contains' without calling the hasher.
+  constexpr bool contains(const hashed_key<key_type>& key) const noexcept {
+    return base::contains(key);
+  }
+
+  /// Does the same as 'lookup' without calling the hasher.
+  constexpr auto lookup(const hashed_key<key_type>& key) noexcept -> iterator {
+    return base::lookup(key);
+  }
+
+  /// Does the same as 'lookup' without calling the hasher.
+  constexpr auto lookup(const hashed_key<key_type>& key) const noexcept
+      -> const_iterator {
+    return base::lookup(key);
+  }
+
+  /// Checks if an element with given key has already been inserted into the
+  /// map without writing to shared memory. With the 'seqlock' policy, this may
+  /// be called by multiple threads while a single thread modifies the map.
+  bool optimistic_contains(const key_type& key) const noexcept  //
+      requires std::is_trivially_copyable_v<key_type> {
+    return base::optimistic_read(
+        key, [](const auto&, size_type, bool found) { return found; });
+  }
+
+  /// Returns a copy of the mapped value of the given key or an empty optional
+  /// if no such element exists. No reference into the table is handed out.
+  /// @see optimistic_contains
+  auto optimistic_lookup(const key_type& key) const
+      -> std::optional<mapped_type>  //
+      requires std::is_trivially_copyable_v<key_type> &&
+      std::is_trivially_copyable_v<mapped_type> {
+    return base::optimistic_read(
+        key,
+        [](const auto& t, size_type index,
+           bool found) -> std::optional<mapped_type> {
+          if (!found) return std::nullopt;
+          return t.value(index);
+        });
+  }
+
+  /// Frees all tables that have been retired by the synchronization policy.
+  /// Only call this when no concurrent reader is active.
+  void reclaim() noexcept  //
+      requires requires(synchronization s) { s.reclaim(); } {
+    base::sync.reclaim();
+  }
+
   /// Returns a reference to the mapped value of the given key. If no such
   /// element exists, an exception of type std::invalid_argument is thrown.
-  auto operator()(const key_type& key) -> mapped_type& {
+  constexpr auto operator()(const key_type& key) -> mapped_type& {
     const auto [index, psl, found] = base::lookup_data(key);
     if (found) return base::table.value(index);
-    throw std::invalid_argument("Failed to find the given key.");
+    detail::raise<std::invalid_argument>("Failed to find the given key.");
   }
 
   /// Returns a constant reference to the mapped value of the given key. If no
   /// such element exists, an exception of type std::invalid_argument is thrown.
-  auto operator()(const key_type& key) const -> const mapped_type& {
+  constexpr auto operator()(const key_type& key) const -> const mapped_type& {
+    return const_cast<flat_map&>(*this).operator()(key);
+  }
+
+  /// Does the same as 'operator()' without calling the hasher.
+  constexpr auto operator()(const hashed_key<key_type>& key) -> mapped_type& {
+    const auto [index, psl, found] =
+        base::lookup_data(key.key, base::hash_of(key));
+    if (found) return base::table.value(index);
+    detail::raise<std::invalid_argument>("Failed to find the given key.");
+  }
+
+  /// Does the same as 'operator()' without calling the hasher.
+  constexpr auto operator()(const hashed_key<key_type>& key) const
+      -> const mapped_type& {
     return const_cast<flat_map&>(*this).operator()(key);
   }
 
@@ -309,15 +495,140 @@ class flat_map
   /// elements into it, and swapping its content with the actual table.
   /// In this case, all iterators and pointers become invalid.
   /// If the given size is smaller than the current table size, nothing happens.
-  void reserve_capacity(size_type count) { base::reserve_capacity(count); }
+  constexpr void reserve_capacity(size_type count) {
+    base::reserve_capacity(count);
+  }
 
   /// Reserves enough memory in the underlying table such that 'count' elements
   /// could be inserted without implicitly triggering a rehash with respect to
   /// the current maximum allowed load factor. @see reserve_capacity
-  void reserve(size_type count) { base::reserve(count); }
+  constexpr void reserve(size_type count) { base::reserve(count); }
+
+  /// Rehashes all elements into the smallest table which 'reserve' would
+  /// choose for the current size to give back unused memory.
+  /// In this case, all iterators and pointers become invalid.
+  constexpr void shrink_to_fit() { base::shrink_to_fit(); }
+
+  /// Swaps the content of both maps without copying or moving elements.
+  constexpr void swap(flat_map& other) noexcept { base::swap(other); }
+
+  /// Calls the given function for every element of the map in the form of a
+  /// pair of references. With a parallel execution policy, the table is divided
+  /// into contiguous chunks of slots which are processed by multiple threads.
+  /// In this case, 'f' has to be safe to be called concurrently and must not
+  /// modify the map except for the referenced values.
+  template <generic::execution_policy Policy, typename F>
+  void for_each(Policy&& policy, F&& f) {
+    base::for_each(policy, f);
+  }
+
+  /// Calls the given function for every element of the map in the form of a
+  /// pair of constant references. @see for_each
+  template <generic::execution_policy Policy, typename F>
+  void for_each(Policy&& policy, F&& f) const {
+    base::for_each(policy, f);
+  }
+
+  /// Transforms every element of the map and reduces the results together with
+  /// the initial value. For parallel execution policies, 'reduce' has to be
+  /// associative. The order of elements is the order of the table slots.
+  template <generic::execution_policy Policy,
+            typename T,
+            typename Reduce,
+            typename Transform>
+  auto transform_reduce(Policy&&  policy,
+                        T         init,
+                        Reduce    reduce,
+                        Transform transform) const -> T {
+    return base::transform_reduce(policy, std::move(init), std::move(reduce),
+                                  std::move(transform));
+  }
 
   /// Clears all the contents of the map without changing its capacitcy.
-  void clear() { base::clear(); }
+  constexpr void clear() { base::clear(); }
+
+  /// Clears all the contents of the map with respect to the given execution
+  /// policy. For parallel policies, elements are destroyed by multiple threads.
+  template <generic::execution_policy Policy>
+  void clear(Policy&& policy) { base::clear(policy); }
+
+  /// Maps all pages of the table in parallel by touching them. Call this after
+  /// 'reserve' to keep page faults out of the first insertions and lookups.
+  void prefault() { base::prefault(execution::par); }
+
+  template <generic::execution_policy Policy>
+  void prefault(Policy&& policy) { base::prefault(policy); }
+
+  /// Hands all elements together with their memory to a background thread
+  /// which destroys them in parallel. The map is left empty with minimal
+  /// capacity and can be used right away. The returned future becomes ready
+  /// when the old elements have been destroyed. Use this to avoid the latency
+  /// of tearing down huge maps with non-trivial elements.
+  /// With a seqlock, the old table is retired until 'reclaim' instead.
+  auto dispose_async() -> std::future<void> { return base::dispose_async(); }
+
+  /// Returns a copy of the allocator used by the map.
+  constexpr auto get_allocator() const noexcept -> allocator {
+    return base::table.get_allocator();
+  }
+
+  /// Forgets all elements and the memory of the map without destroying and
+  /// deallocating them. Afterwards, the map is empty with minimal capacity.
+  /// This is meant for arena allocators, such as 'std::pmr' allocators with a
+  /// 'std::pmr::monotonic_buffer_resource', whose memory is released at once.
+  /// Elements that own further memory must have allocated it from the arena.
+  constexpr void release() { base::release(); }
+
+  /// Returns the bytes allocated by the map. All slots of the table are taken
+  /// into account and not only the occupied ones. Memory owned by the elements
+  /// themselves, like the buffer of a string, is not included.
+  auto memory_usage() const noexcept -> robin_hood::memory_usage {
+    return base::memory_usage();
+  }
+
+  /// Returns the bytes allocated by the map and its elements. The given
+  /// function is called with a pair of references to the key and the value
+  /// of every element and has to return the count of bytes owned by them.
+  template <typename F>
+  auto memory_usage(F&& owned) const -> robin_hood::memory_usage {
+    return base::memory_usage(std::forward<F>(owned));
+  }
+
+  /// Writes the map to the given binary stream. Together with all elements,
+  /// the layout of the table is stored such that 'load' is able to put them
+  /// back into their slots without rehashing. Keys and values are written by
+  /// the given serializers. @see serializer
+  template <generic::serializer<Key>   KeySerializer   = serializer<Key>,
+            generic::serializer<Value> ValueSerializer = serializer<Value>>
+  void save(std::ostream&          os,
+            const KeySerializer&   keys   = {},
+            const ValueSerializer& values = {}) const {
+    base::serialize(os, [&](std::ostream& os, size_type index) {
+      keys.write(os, base::table.key(index));
+      values.write(os, base::table.value(index));
+    });
+  }
+
+  /// Replaces the content of the map by the one written by 'save'. The map
+  /// has to use the same hash function. Otherwise, or if the stream does not
+  /// contain a valid map of the given types, an exception of type
+  /// 'std::invalid_argument' is thrown and the map stays unchanged.
+  template <generic::serializer<Key>   KeySerializer   = serializer<Key>,
+            generic::serializer<Value> ValueSerializer = serializer<Value>>
+  void load(std::istream&          is,
+            const KeySerializer&   keys   = {},
+            const ValueSerializer& values = {}) {
+    base::deserialize(is, [&](std::istream& is, auto& table, size_type index) {
+      table.construct_key(index, keys.read(is));
+      LYRAHGAMES_ROBIN_HOOD_TRY {
+        table.construct_value(index, values.read(is));
+      }
+      LYRAHGAMES_ROBIN_HOOD_CATCH {
+        table.destroy_key(index);
+        LYRAHGAMES_ROBIN_HOOD_RETHROW;
+      }
+    });
+  }
 
   /// Statically insert a given element into the map without reallocation and
   /// rehashing. If a reallocation would take place, the functions throws an
@@ -325,7 +636,8 @@ class flat_map
   /// function throws an exception of type 'std::invalid_argument'.
   template <generic::forwardable<key_type>    K,
             generic::forwardable<mapped_type> V>
-  void static_insert(K&& key, V&& value) {
+  constexpr void static_insert(K&& key, V&& value) {
+    const auto section = base::write_section();
     const auto index = base::static_insert_key(std::forward<K>(key));
     base::table.construct_value(index, std::forward<V>(value));
   }
@@ -336,8 +648,9 @@ class flat_map
   /// 'std::overlow_error'. If the key has already been inserted, the function
   /// throws an exception of type 'std::invalid_argument'.
   template <generic::forwardable<key_type> K>
-  void static_insert(K&& key)  //
+  constexpr void static_insert(K&& key)  //
       requires std::default_initializable<mapped_type> {
+    const auto section = base::write_section();
     const auto index = base::static_insert_key(std::forward<K>(key));
     base::table.construct_value(index);
   }
@@ -345,39 +658,48 @@ class flat_map
   /// Statically insert a given element into the map without reallocation and
   /// rehashing. If a reallocation would take place or if the key has already
   /// been inserted, the function does nothing.
+  /// Returns an iterator to the element and the status of the insertion.
   template <generic::forwardable<key_type>    K,
             generic::forwardable<mapped_type> V>
-  void try_static_insert(K&& key, V&& value) {
-    const auto [index, done] =
-        base::try_static_insert_key(std::forward<K>(key));
-    if (!done) return;
-    base::table.construct_value(index, std::forward<V>(value));
+  constexpr auto try_static_insert(K&& key, V&& value)
+      -> std::pair<iterator, insert_status> {
+    const auto section = base::write_section();
+    const auto result  = base::try_static_insert_key(std::forward<K>(key));
+    if (result.second == insert_status::inserted)
+      base::table.construct_value(result.first, std::forward<V>(value));
+    return base::insert_result(result);
   }
 
   /// Statically insert a given element into the map without reallocation and
   /// rehashing. The value of the element is default constructed. If a
   /// reallocation would take place or if the key has already been inserted, the
   /// function does nothing.
+  /// Returns an iterator to the element and the status of the insertion.
   template <generic::forwardable<key_type> K>
-  void try_static_insert(K&& key)  //
+  constexpr auto try_static_insert(K&& key)
+      -> std::pair<iterator, insert_status>  //
       requires std::default_initializable<mapped_type> {
-    const auto [index, done] =
-        base::try_static_insert_key(std::forward<K>(key));
-    if (!done) return;
-    base::table.construct_value(index);
+    const auto section = base::write_section();
+    const auto result  = base::try_static_insert_key(std::forward<K>(key));
+    if (result.second == insert_status::inserted)
+      base::table.construct_value(result.first);
+    return base::insert_result(result);
   }
 
   /// Statically inserts a given element into the map without reallocation and
   /// rehashing and without checking for overload. The function assumes that
   /// after insertion the maximum load factor will not be exceeded. If the key
   /// has already been inserted, the function does nothing.
+  /// Returns an iterator to the element and the status of the insertion.
   template <generic::forwardable<key_type>    K,
             generic::forwardable<mapped_type> V>
-  void nocheck_static_insert(K&& key, V&& value) {
-    const auto [index, done] =
-        base::nocheck_static_insert_key(std::forward<K>(key));
-    if (!done) return;
-    base::table.construct_value(index, std::forward<V>(value));
+  constexpr auto nocheck_static_insert(K&& key, V&& value)
+      -> std::pair<iterator, insert_status> {
+    const auto section = base::write_section();
+    const auto result  = base::nocheck_static_insert_key(std::forward<K>(key));
+    if (result.second == insert_status::inserted)
+      base::table.construct_value(result.first, std::forward<V>(value));
+    return base::insert_result(result);
   }
 
   /// Statically insert a given element into the map without reallocation and
@@ -385,13 +707,16 @@ class flat_map
   /// after insertion the maximum load factor will not be exceeded. The value of
   /// the element is default constructed. If the key has already been inserted,
   /// the function does nothing.
+  /// Returns an iterator to the element and the status of the insertion.
   template <generic::forwardable<key_type> K>
-  void nocheck_static_insert(K&& key)  //
+  constexpr auto nocheck_static_insert(K&& key)
+      -> std::pair<iterator, insert_status>  //
       requires std::default_initializable<mapped_type> {
-    const auto [index, done] =
-        base::nocheck_static_insert_key(std::forward<K>(key));
-    if (!done) return;
-    base::table.construct_value(index);
+    const auto section = base::write_section();
+    const auto result  = base::nocheck_static_insert_key(std::forward<K>(key));
+    if (result.second == insert_status::inserted)
+      base::table.construct_value(result.first);
+    return base::insert_result(result);
   }
 
   /// Insert a given element into the map with possible reallocation and
@@ -399,7 +724,8 @@ class flat_map
   /// function throws an exception of type 'std::invalid_argument'.
   template <generic::forwardable<key_type>    K,
             generic::forwardable<mapped_type> V>
-  void insert(K&& key, V&& value) {
+  constexpr void insert(K&& key, V&& value) {
+    const auto section = base::write_section();
     const auto index = base::insert_key(std::forward<K>(key));
     base::table.construct_value(index, std::forward<V>(value));
   }
@@ -408,38 +734,96 @@ class flat_map
   /// rehashing. The value is default constructed. If the key has already been
   /// inserted, an exception of type 'std::invalid_argument' is thrown.
   template <generic::forwardable<key_type> K>
-  void insert(K&& key)  //
+  constexpr void insert(K&& key)  //
       requires std::default_initializable<mapped_type> {
+    const auto section = base::write_section();
     const auto index = base::insert_key(std::forward<K>(key));
     base::table.construct_value(index);
   }
 
   /// Insert a given element into the map with possible reallocation and
   /// rehashing. If the key has already been inserted, nothing is done.
+  /// Returns an iterator to the element and the status of the insertion.
   template <generic::forwardable<key_type>    K,
             generic::forwardable<mapped_type> V>
-  void try_insert(K&& key, V&& value) {
-    const auto [index, done] = base::try_insert_key(std::forward<K>(key));
-    if (!done) return;
-    base::table.construct_value(index, std::forward<V>(value));
+  constexpr auto try_insert(K&& key, V&& value)
+      -> std::pair<iterator, insert_status> {
+    const auto section = base::write_section();
+    const auto result  = base::try_insert_key(std::forward<K>(key));
+    if (result.second == insert_status::inserted)
+      base::table.construct_value(result.first, std::forward<V>(value));
+    return base::insert_result(result);
   }
 
   /// Insert a given element into the map with possible reallocation and
   /// rehashing. The value is default constructed. If the key has already been
   /// inserted, nothing is done.
+  /// Returns an iterator to the element and the status of the insertion.
   template <generic::forwardable<key_type> K>
-  void try_insert(K&& key)  //
+  constexpr auto try_insert(K&& key)
+      -> std::pair<iterator, insert_status>  //
       requires std::default_initializable<mapped_type> {
-    const auto [index, done] = base::try_insert_key(std::forward<K>(key));
-    if (!done) return;
-    base::table.construct_value(index);
+    const auto section = base::write_section();
+    const auto result  = base::try_insert_key(std::forward<K>(key));
+    if (result.second == insert_status::inserted)
+      base::table.construct_value(result.first);
+    return base::insert_result(result);
+  }
+
+  /// Does the same as 'insert' without calling the hasher for the lookup.
+  template <generic::forwardable<mapped_type> V>
+  constexpr void insert(const hashed_key<key_type>& key, V&& value) {
+    const auto section         = base::write_section();
+    const auto [index, status] =
+        base::try_insert_key(key.key, base::hash_of(key));
+    if (status != insert_status::inserted) base::fail(status);
+    base::table.construct_value(index, std::forward<V>(value));
+  }
+
+  /// Does the same as 'try_insert' without calling the hasher for the lookup.
+  template <generic::forwardable<mapped_type> V>
+  constexpr auto try_insert(const hashed_key<key_type>& key, V&& value)
+      -> std::pair<iterator, insert_status> {
+    const auto section = base::write_section();
+    const auto result  = base::try_insert_key(key.key, base::hash_of(key));
+    if (result.second == insert_status::inserted)
+      base::table.construct_value(result.first, std::forward<V>(value));
+    return base::insert_result(result);
+  }
+
+  /// Does the same as 'insert' for a key whose value of the hasher has already
+  /// been computed by 'hashed'. The key is moved into the map.
+  template <generic::forwardable<mapped_type> V>
+  constexpr void insert(key_type&&                  key,
+                        const hashed_key<key_type>& hashed,
+                        V&&                         value) {
+    const auto section         = base::write_section();
+    const auto [index, status] =
+        base::try_insert_key(std::move(key), base::hash_of(hashed));
+    if (status != insert_status::inserted) base::fail(status);
+    base::table.construct_value(index, std::forward<V>(value));
+  }
+
+  /// Does the same as 'try_insert' for a key whose value of the hasher has
+  /// already been computed. The key is only moved if it is inserted.
+  template <generic::forwardable<mapped_type> V>
+  constexpr auto try_insert(key_type&&                  key,
+                            const hashed_key<key_type>& hashed,
+                            V&&                         value)
+      -> std::pair<iterator, insert_status> {
+    const auto section = base::write_section();
+    const auto result  =
+        base::try_insert_key(std::move(key), base::hash_of(hashed));
+    if (result.second == insert_status::inserted)
+      base::table.construct_value(result.first, std::forward<V>(value));
+    return base::insert_result(result);
   }
 
   /// Insert pair of elements into the map by using the given input range.
   /// If a key occurs multiple times then the last pair will be used to set the
   /// value of the respective element.
   template <generic::pair_input_range<key_type, mapped_type> T>
-  void insert(const T& data) {
+  constexpr void insert(const T& data) {
     reserve(std::ranges::size(data) + size());
     for (const auto& [k, v] : data)
       nocheck_static_insert_or_assign(k, v);
@@ -450,7 +834,7 @@ class flat_map
   /// occurence is used to set its value.
   template <generic::input_range<key_type>    K,
             generic::input_range<mapped_type> V>
-  void insert(const K& keys, const V& values) {
+  constexpr void insert(const K& keys, const V& values) {
     using namespace std;
     assert(ranges::size(keys) == ranges::size(values));
     reserve(ranges::size(keys) + size());
@@ -462,8 +846,9 @@ class flat_map
   /// Statically emplace a new element into the map by constructing its value in
   /// place. This function uses perfect forwarding construction.
   template <generic::forwardable<key_type> K, typename... arguments>
-  void static_emplace(K&& key, arguments&&... args)  //
+  constexpr void static_emplace(K&& key, arguments&&... args)  //
       requires std::constructible_from<mapped_type, arguments...> {
+    const auto section = base::write_section();
     const auto index = base::static_insert_key(std::forward<K>(key));
     base::table.construct_value(index, std::forward<arguments>(args)...);
   }
@@ -472,51 +857,67 @@ class flat_map
   /// in place. This function uses perfect forwarding construction. If the given
   /// key already exists or if the map would have to reallocate new storage, the
   /// function does nothing.
+  /// Returns an iterator to the element and the status of the insertion.
   template <generic::forwardable<key_type> K, typename... arguments>
-  void try_static_emplace(K&& key, arguments&&... args)  //
+  constexpr auto try_static_emplace(K&& key, arguments&&... args)
+      -> std::pair<iterator, insert_status>  //
       requires std::constructible_from<mapped_type, arguments...> {
-    const auto [index, done] =
-        base::try_static_insert_key(std::forward<K>(key));
-    if (!done) return;
-    base::table.construct_value(index, std::forward<arguments>(args)...);
+    const auto section = base::write_section();
+    const auto result  = base::try_static_insert_key(std::forward<K>(key));
+    if (result.second == insert_status::inserted)
+      base::table.construct_value(result.first,
+                                  std::forward<arguments>(args)...);
+    return base::insert_result(result);
   }
 
   /// Statically emplaces a new element into the map by constructing its value
   /// in place. This function uses perfect forwarding construction. If the given
   /// key already exists, the function does nothing. Furthermore, the function
   /// assumes that after emplacement the maximum load factor is not exceeded.
+  /// Returns an iterator to the element and the status of the insertion.
   template <generic::forwardable<key_type> K, typename... arguments>
-  void nocheck_static_emplace(K&& key, arguments&&... args)  //
+  constexpr auto nocheck_static_emplace(K&& key, arguments&&... args)
+      -> std::pair<iterator, insert_status>  //
       requires std::constructible_from<mapped_type, arguments...> {
-    const auto [index, done] =
-        base::nocheck_static_insert_key(std::forward<K>(key));
-    if (!done) return;
-    base::table.construct_value(index, std::forward<arguments>(args)...);
+    const auto section = base::write_section();
+    const auto result  = base::nocheck_static_insert_key(std::forward<K>(key));
+    if (result.second == insert_status::inserted)
+      base::table.construct_value(result.first,
+                                  std::forward<arguments>(args)...);
+    return base::insert_result(result);
   }
 
   /// Emplace a new element into the map by constructing its value in place.
   /// This function uses perfect forwarding construction.
   template <generic::forwardable<key_type> K, typename... arguments>
-  void emplace(K&& key, arguments&&... args)  //
+  constexpr void emplace(K&& key, arguments&&... args)  //
       requires std::constructible_from<mapped_type, arguments...> {
+    const auto section = base::write_section();
     const auto index = base::insert_key(std::forward<K>(key));
     base::table.construct_value(index, std::forward<arguments>(args)...);
   }
 
   /// Emplace a new element into the map by constructing its value in
   /// place. This function uses perfect forwarding construction.
+  /// Returns an iterator to the element and the status of the insertion.
   template <generic::forwardable<key_type> K, typename... arguments>
-  void try_emplace(K&& key, arguments&&... args)  //
+  constexpr auto try_emplace(K&& key, arguments&&... args)
+      -> std::pair<iterator, insert_status>  //
       requires std::constructible_from<mapped_type, arguments...> {
-    const auto index = base::try_insert_key(std::forward<K>(key));
-    base::table.construct_value(index, std::forward<arguments>(args)...);
+    const auto section = base::write_section();
+    const auto result  = base::try_insert_key(std::forward<K>(key));
+    if (result.second == insert_status::inserted)
+      base::table.construct_value(result.first,
+                                  std::forward<arguments>(args)...);
+    return base::insert_result(result);
   }
 
   /// Access the element given by key and assign the given value to it.
   /// If the key does not exist then an exception of type
   /// 'std::invalid_argument' is thrown.
   template <generic::forwardable<mapped_type> V>
-  void assign(const key_type& key, V&& value) {
+  constexpr void assign(const key_type& key, V&& value) {
+    const auto section = base::write_section();
     operator()(key) = std::forward<V>(value);
   }
 
@@ -524,7 +925,8 @@ class flat_map
   /// Otherwise, assigns a new value to it.
   template <generic::forwardable<key_type>    K,
             generic::forwardable<mapped_type> V>
-  void nocheck_static_insert_or_assign(K&& key, V&& value) {
+  constexpr void nocheck_static_insert_or_assign(K&& key, V&& value) {
+    const auto section = base::write_section();
     decltype(auto) k         = forward_construct<Key>(std::forward<K>(key));
     auto [index, psl, found] = base::lookup_data(k);
     if (found) {
@@ -539,7 +941,8 @@ class flat_map
   /// Otherwise, assigns a new value to it.
   template <generic::forwardable<key_type>    K,
             generic::forwardable<mapped_type> V>
-  void insert_or_assign(K&& key, V&& value) {
+  constexpr void insert_or_assign(K&& key, V&& value) {
+    const auto section = base::write_section();
     decltype(auto) k         = forward_construct<Key>(std::forward<K>(key));
     auto [index, psl, found] = base::lookup_data(k);
     if (found) {
@@ -555,8 +958,9 @@ class flat_map
   /// key will be inserted with a default initialized value to which a reference
   /// is returned.
   template <generic::forwardable<key_type> K>
-  auto operator[](K&& key) -> mapped_type&  //
+  constexpr auto operator[](K&& key) -> mapped_type&  //
       requires std::default_initializable<mapped_type> {
+    const auto section = base::write_section();
     decltype(auto) k = forward_construct<key_type>(std::forward<K>(key));
     auto [index, psl, found] = base::lookup_data(k);
     if (found) return base::table.value(index);
@@ -565,22 +969,116 @@ class flat_map
     return base::table.value(index);
   }
 
+  /// Returns a reference to the value of the given key. If the key has not
+  /// been inserted, it is inserted together with the value returned by the
+  /// given factory. The factory is only invoked for missing keys and the key
+  /// is only looked up once. Contrary to 'operator[]', the value type does not
+  /// need to be default constructible. A value returned by the factory is
+  /// constructed directly inside its slot. So, the factory must not access the
+  /// map. If the factory throws, the key is removed again and the elements of
+  /// the map stay unchanged.
+  template <generic::forwardable<key_type> K, std::invocable F>
+  constexpr auto get_or_insert_with(K&& key, F&& factory) -> mapped_type&  //
+      requires std::constructible_from<mapped_type, std::invoke_result_t<F>> {
+    const auto section = base::write_section();
+    decltype(auto) k = forward_construct<key_type>(std::forward<K>(key));
+    auto [index, psl, found] = base::lookup_data(k);
+    if (found) return base::table.value(index);
+    // All reallocations happen before the key is inserted.
+    // So, the index stays valid while the factory is running.
+    index = base::basic_insert_key(index, psl, std::forward<decltype(k)>(k));
+    LYRAHGAMES_ROBIN_HOOD_TRY {
+      base::table.construct_value_with(index, std::forward<F>(factory));
+    }
+    LYRAHGAMES_ROBIN_HOOD_CATCH {
+      base::basic_remove_key(index);
+      LYRAHGAMES_ROBIN_HOOD_RETHROW;
+    }
+    return base::table.value(index);
+  }
+
+  /// Inserts the given element if its key has not been inserted. Otherwise,
+  /// the old value is combined with the given one by calling 'combine(old,
+  /// value)'. The function may either modify 'old' in place or return the new
+  /// value, e.g. 'std::plus{}'. In both cases, the key is only looked up once.
+  /// Returns a reference to the resulting value.
+  template <generic::forwardable<key_type>    K,
+            generic::forwardable<mapped_type> V,
+            typename F>
+  constexpr auto merge(K&& key, V&& value, F&& combine) -> mapped_type&  //
+      requires std::invocable<F, mapped_type&, V> {
+    const auto section = base::write_section();
+    decltype(auto) k = forward_construct<key_type>(std::forward<K>(key));
+    auto [index, psl, found] = base::lookup_data(k);
+    if (found) {
+      auto& old = base::table.value(index);
+      base::update(old, std::forward<F>(combine), std::forward<V>(value));
+      return old;
+    }
+    index = base::basic_insert_key(index, psl, std::forward<decltype(k)>(k));
+    base::table.construct_value(index, std::forward<V>(value));
+    return base::table.value(index);
+  }
+
+  /// Merges all pairs of the given input range one after another by a single
+  /// write operation. Contrary to 'insert', no memory is reserved in advance
+  /// because such ranges typically contain many equal keys. @see merge
+  template <generic::pair_input_range<key_type, mapped_type> T, typename F>
+  constexpr void merge(const T& data, F&& combine)  //
+      requires std::invocable<F&, mapped_type&, const mapped_type&> {
+    const auto section = base::write_section();
+    for (const auto& [k, v] : data)
+      merge(k, v, combine);
+  }
+
+  /// Inserts the given key with a value constructed from 'init' if it has not
+  /// been inserted. Otherwise, its value is updated by calling 'update(old)'
+  /// which either modifies 'old' in place or returns the new value. The key is
+  /// only looked up once. Returns a reference to the resulting value.
+  template <generic::forwardable<key_type>    K,
+            generic::forwardable<mapped_type> V,
+            typename F>
+  constexpr auto upsert(K&& key, V&& init, F&& update) -> mapped_type&  //
+      requires std::invocable<F, mapped_type&> {
+    const auto section = base::write_section();
+    decltype(auto) k = forward_construct<key_type>(std::forward<K>(key));
+    auto [index, psl, found] = base::lookup_data(k);
+    if (found) {
+      auto& old = base::table.value(index);
+      base::update(old, std::forward<F>(update));
+      return old;
+    }
+    index = base::basic_insert_key(index, psl, std::forward<decltype(k)>(k));
+    base::table.construct_value(index, std::forward<V>(init));
+    return base::table.value(index);
+  }
+
   /// Removes an element from the map with the given key.
   /// If there is no such element, throws an exception of type
   /// 'std::invalid_argument'.
-  void remove(const key_type& key) { base::remove(key); }
+  constexpr void remove(const key_type& key) { base::remove(key); }
 
   /// Removes an element from the map with the given key.
   /// If there is no such element, nothing is done.
-  void try_remove(const key_type& key) { base::try_remove(key); }
+  constexpr void try_remove(const key_type& key) { base::try_remove(key); }
+
+  /// Does the same as 'remove' without calling the hasher.
+  constexpr void remove(const hashed_key<key_type>& key) {
+    base::remove(key.key, base::hash_of(key));
+  }
+
+  /// Does the same as 'try_remove' without calling the hasher.
+  constexpr void try_remove(const hashed_key<key_type>& key) {
+    base::try_remove(key.key, base::hash_of(key));
+  }
 
   /// Removes the element pointed to by the given iterator.
   /// This functions assumes the iterator is pointing to an existing element.
-  void remove(iterator it) { base::remove(it); }
+  constexpr void remove(iterator it) { base::remove(it); }
 
   /// Removes the element pointed to by the given iterator.
   /// This functions assumes the iterator is pointing to an existing element.
-  void remove(const_iterator it) { base::remove(it); }
+  constexpr void remove(const_iterator it) { base::remove(it); }
 };
 
 template <generic::key                       Key,
@@ -588,10 +1086,10 @@ template <generic::key                       Key,
           generic::hasher<Key>               Hasher    = std::hash<Key>,
           generic::equivalence_relation<Key> Equality  = std::equal_to<Key>,
           generic::allocator                 Allocator = std::allocator<Key>>
-inline auto auto_flat_map(size_t           size,
-                          const Hasher&    hash  = {},
-                          const Equality&  equal = {},
-                          const Allocator& alloc = {}) {
+constexpr auto auto_flat_map(size_t           size,
+                             const Hasher&    hash  = {},
+                             const Equality&  equal = {},
+                             const Allocator& alloc = {}) {
   return flat_map<Key, Value, Hasher, Equality, Allocator>(size, hash, equal,
                                                            alloc);
 }
@@ -601,10 +1099,10 @@ template <generic::key                       Key,
           generic::hasher<Key>               Hasher    = std::hash<Key>,
           generic::equivalence_relation<Key> Equality  = std::equal_to<Key>,
           generic::allocator                 Allocator = std::allocator<Key>>
-inline auto auto_flat_map(std::initializer_list<std::pair<Key, Value>> list,
-                          const Hasher&    hash  = {},
-                          const Equality&  equal = {},
-                          const Allocator& alloc = {}) {
+constexpr auto auto_flat_map(std::initializer_list<std::pair<Key, Value>> list,
+                             const Hasher&    hash  = {},
+                             const Equality&  equal = {},
+                             const Allocator& alloc = {}) {
   return flat_map<Key, Value, Hasher, Equality, Allocator>(list, hash, equal,
                                                            alloc);
 }
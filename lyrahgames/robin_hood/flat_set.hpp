@@ -3,14 +3,22 @@
 #include <cmath>
 #include <concepts>
 #include <functional>
+#include <future>
 #include <iomanip>
 #include <iostream>
 #include <memory>
+#include <type_traits>
 //
 #include <lyrahgames/xstd/math.hpp>
 #include <lyrahgames/xstd/swap.hpp>
 //
+#include <lyrahgames/robin_hood/capacity.hpp>
+#include <lyrahgames/robin_hood/hashed_key.hpp>
+#include <lyrahgames/robin_hood/insert_status.hpp>
 #include <lyrahgames/robin_hood/meta.hpp>
+#include <lyrahgames/robin_hood/mixer.hpp>
+#include <lyrahgames/robin_hood/prefault.hpp>
+#include <lyrahgames/robin_hood/synchronization.hpp>
 //
 #include <lyrahgames/robin_hood/detail/flat_key_table.hpp>
 #include <lyrahgames/robin_hood/detail/hash_base.hpp>
@@ -20,271 +28,411 @@ namespace lyrahgames::robin_hood {
 template <generic::key                       Key,
           generic::hasher<Key>               Hasher    = std::hash<Key>,
           generic::equivalence_relation<Key> Equality  = std::equal_to<Key>,
-          generic::allocator                 Allocator = std::allocator<Key>>
+          generic::allocator                 Allocator = std::allocator<Key>,
+          typename Synchronization = unsynchronized,
+          typename Capacity        = power_of_two_capacity,
+          typename Mixer           = default_mixer<Capacity>>
 class flat_set;
 
-#define TEMPLATE                                           \
-  template <generic::key Key, generic::hasher<Key> Hasher, \
-            generic::equivalence_relation<Key> Equality,   \
-            generic::allocator                 Allocator>
-#define FLAT_SET flat_set<Key, Hasher, Equality, Allocator>
+#define TEMPLATE                                                \
+  template <generic::key Key, generic::hasher<Key> Hasher,      \
+            generic::equivalence_relation<Key> Equality,        \
+            generic::allocator                 Allocator,       \
+            typename                           Synchronization, \
+            typename                           Capacity,        \
+            typename                           Mixer>
+#define FLAT_SET \
+  flat_set<Key, Hasher, Equality, Allocator, Synchronization, Capacity, Mixer>
 
 TEMPLATE
-using flat_set_base =
-    detail::hash_base<detail::flat_key_table<Key, Allocator>, Hasher, Equality>;
+using flat_set_base = detail::hash_base<detail::flat_key_table<Key, Allocator>,
+                                        Hasher,
+                                        Equality,
+                                        Synchronization,
+                                        Capacity,
+                                        Mixer>;
 
 TEMPLATE
-class flat_set : private flat_set_base<Key, Hasher, Equality, Allocator> {
+class flat_set : private flat_set_base<Key,
+                                       Hasher,
+                                       Equality,
+                                       Allocator,
+                                       Synchronization,
+                                       Capacity,
+                                       Mixer> {
  public:
-  using base           = flat_set_base<Key, Hasher, Equality, Allocator>;
-  using key_type       = Key;
-  using allocator      = Allocator;
-  using hasher         = Hasher;
-  using equality       = Equality;
-  using size_type      = typename base::size_type;
-  using real           = typename base::real;
-  using const_iterator = typename base::const_iterator;
-  using iterator       = typename base::iterator;
+  using base = flat_set_base<Key,
+                             Hasher,
+                             Equality,
+                             Allocator,
+                             Synchronization,
+                             Capacity,
+                             Mixer>;
+  using key_type        = Key;
+  using allocator       = Allocator;
+  using hasher          = Hasher;
+  using equality        = Equality;
+  using synchronization = Synchronization;
+  using capacity_policy = Capacity;
+  using mixer           = Mixer;
+  using size_type       = typename base::size_type;
+  using psl_type        = typename base::psl_type;
+  using real            = typename base::real;
+  using const_iterator  = typename base::const_iterator;
+  using iterator        = typename base::iterator;
 
   /// Used for statistics and logging tests.
   using base::lookup_data;
 
   flat_set() = default;
 
-  flat_set(size_type s,
-           real      m,
-           hasher    h = {},
-           equality  e = {},
-           allocator a = {})
+  /// Copies the given set by copy constructing its elements in contiguous
+  /// chunks of slots with respect to the given execution policy.
+  template <generic::execution_policy Policy>
+  flat_set(Policy&& policy, const flat_set& other) : base(policy, other) {}
+
+  constexpr flat_set(size_type s,
+                     real      m,
+                     hasher    h = {},
+                     equality  e = {},
+                     allocator a = {})
       : base(s, m, h, e, a) {}
 
-  flat_set(size_type s, real m, allocator a)
+  constexpr flat_set(size_type s, real m, allocator a)
       : flat_set(s, m, hasher{}, equality{}, a) {}
 
-  flat_set(size_type s, real m, hasher h, allocator a)
+  constexpr flat_set(size_type s, real m, hasher h, allocator a)
       : flat_set(s, m, h, equality{}, a) {}
 
-  explicit flat_set(size_type s,
-                    hasher    h = {},
-                    equality  e = {},
-                    allocator a = {})
+  constexpr explicit flat_set(size_type s,
+                              hasher    h = {},
+                              equality  e = {},
+                              allocator a = {})
       : base(s, h, e, a) {}
 
-  flat_set(size_type s, allocator a) : flat_set(s, hasher{}, equality{}, a) {}
+  constexpr flat_set(size_type s, allocator a)
+      : flat_set(s, hasher{}, equality{}, a) {}
 
-  flat_set(size_type s, hasher h, allocator a)
+  constexpr flat_set(size_type s, hasher h, allocator a)
       : flat_set(s, h, equality{}, a) {}
 
+  /// Reserves memory for the given count of elements and prefaults it.
+  /// @see prefault
+  flat_set(prefault_t,
+          size_type s,
+          hasher    h = {},
+          equality  e = {},
+          allocator a = {})
+      : flat_set(s, h, e, a) {
+    prefault();
+  }
+
   template <generic::input_range<key_type> T>
-  explicit flat_set(const T&  data,
-                    hasher    h = {},
-                    equality  e = {},
-                    allocator a = {})
+  constexpr explicit flat_set(const T&  data,
+                              hasher    h = {},
+                              equality  e = {},
+                              allocator a = {})
       : flat_set(std::ranges::size(data), h, e, a) {
     for (const auto& k : data)
       nocheck_static_insert(k);
   }
 
   template <generic::input_range<key_type> T>
-  flat_set(const T& data, allocator a)
+  constexpr flat_set(const T& data, allocator a)
       : flat_set(data, hasher{}, equality{}, a) {}
 
   template <generic::input_range<key_type> T>
-  flat_set(const T& data, hasher h, allocator a)
+  constexpr flat_set(const T& data, hasher h, allocator a)
       : flat_set(data, h, equality{}, a) {}
 
   template <generic::input_range<key_type> T>
-  flat_set(const T&  data,
-           real      m,
-           hasher    h = {},
-           equality  e = {},
-           allocator a = {})
+  constexpr flat_set(const T&  data,
+                     real      m,
+                     hasher    h = {},
+                     equality  e = {},
+                     allocator a = {})
       : flat_set(std::ranges::size(data), m, h, e, a) {
     for (const auto& k : data)
       nocheck_static_insert(k);
   }
 
   template <generic::input_range<key_type> T>
-  flat_set(const T& data, real m, allocator a)
+  constexpr flat_set(const T& data, real m, allocator a)
       : flat_set(data, m, hasher{}, equality{}, a) {}
 
   template <generic::input_range<key_type> T>
-  flat_set(const T& data, real m, hasher h, allocator a)
+  constexpr flat_set(const T& data, real m, hasher h, allocator a)
       : flat_set(data, m, h, equality{}, a) {}
 
   template <generic::input_range<key_type> T>
-  flat_set(const T&  data,
-           size_type s,
-           real      m,
-           hasher    h = {},
-           equality  e = {},
-           allocator a = {})
+  constexpr flat_set(const T&  data,
+                     size_type s,
+                     real      m,
+                     hasher    h = {},
+                     equality  e = {},
+                     allocator a = {})
       : flat_set(std::max(std::ranges::size(data), s), m, h, e, a) {
     for (const auto& k : data)
       nocheck_static_insert(k);
   }
 
   template <generic::input_range<key_type> T>
-  flat_set(const T& data, size_type s, real m, allocator a)
+  constexpr flat_set(const T& data, size_type s, real m, allocator a)
       : flat_set(data, s, m, hasher{}, equality{}, a) {}
 
   template <generic::input_range<key_type> T>
-  flat_set(const T& data, size_type s, real m, hasher h, allocator a)
+  constexpr flat_set(const T& data, size_type s, real m, hasher h, allocator a)
       : flat_set(data, s, m, h, equality{}, a) {}
 
   template <generic::input_range<key_type> T>
-  flat_set(const T&  data,
-           size_type s,
-           hasher    h = {},
-           equality  e = {},
-           allocator a = {})
+  constexpr flat_set(const T&  data,
+                     size_type s,
+                     hasher    h = {},
+                     equality  e = {},
+                     allocator a = {})
       : flat_set(std::max(s, std::ranges::size(data)), h, e, a) {
     for (const auto& k : data)
       nocheck_static_insert(k);
   }
 
   template <generic::input_range<key_type> T>
-  flat_set(const T& data, size_type s, allocator a)
+  constexpr flat_set(const T& data, size_type s, allocator a)
       : flat_set(data, s, hasher{}, equality{}, a) {}
 
   template <generic::input_range<key_type> T>
-  flat_set(const T& data, size_type s, hasher h, allocator a)
+  constexpr flat_set(const T& data, size_type s, hasher h, allocator a)
       : flat_set(data, s, h, equality{}, a) {}
 
-  explicit flat_set(std::initializer_list<key_type> list,
-                    hasher                          h = {},
-                    equality                        e = {},
-                    allocator                       a = {})
+  constexpr explicit flat_set(std::initializer_list<key_type> list,
+                              hasher                          h = {},
+                              equality                        e = {},
+                              allocator                       a = {})
       : flat_set(std::ranges::size(list), h, e, a) {
     for (const auto& k : list)
       nocheck_static_insert(k);
   }
 
-  flat_set(std::initializer_list<key_type> list, allocator a)
+  constexpr flat_set(std::initializer_list<key_type> list, allocator a)
       : flat_set(list, hasher{}, equality{}, a) {}
 
-  flat_set(std::initializer_list<key_type> list, hasher h, allocator a)
+  constexpr flat_set(std::initializer_list<key_type> list,
+                     hasher                          h,
+                     allocator                       a)
       : flat_set(list, h, equality{}, a) {}
 
-  flat_set(std::initializer_list<key_type> list,
-           size_type                       s,
-           hasher                          h = {},
-           equality                        e = {},
-           allocator                       a = {})
+  constexpr flat_set(std::initializer_list<key_type> list,
+                     size_type                       s,
+                     hasher                          h = {},
+                     equality                        e = {},
+                     allocator                       a = {})
       : flat_set(std::max(s, std::ranges::size(list)), h, e, a) {
     for (const auto& k : list)
       nocheck_static_insert(k);
   }
 
-  flat_set(std::initializer_list<key_type> list, size_type s, allocator a)
+  constexpr flat_set(std::initializer_list<key_type> list,
+                     size_type                       s,
+                     allocator                       a)
       : flat_set(list, s, hasher{}, equality{}, a) {}
 
-  flat_set(std::initializer_list<key_type> list,
-           size_type                       s,
-           hasher                          h,
-           allocator                       a)
+  constexpr flat_set(std::initializer_list<key_type> list,
+                     size_type                       s,
+                     hasher                          h,
+                     allocator                       a)
       : flat_set(list, s, h, equality{}, a) {}
 
-  flat_set(std::initializer_list<key_type> list,
-           real                            m,
-           hasher                          h = {},
-           equality                        e = {},
-           allocator                       a = {})
+  constexpr flat_set(std::initializer_list<key_type> list,
+                     real                            m,
+                     hasher                          h = {},
+                     equality                        e = {},
+                     allocator                       a = {})
       : flat_set(std::ranges::size(list), m, h, e, a) {
     for (const auto& k : list)
       nocheck_static_insert(k);
   }
 
-  flat_set(std::initializer_list<key_type> list, real m, allocator a)
+  constexpr flat_set(std::initializer_list<key_type> list, real m, allocator a)
       : flat_set(list, m, hasher{}, equality{}, a) {}
 
-  flat_set(std::initializer_list<key_type> list, real m, hasher h, allocator a)
+  constexpr flat_set(std::initializer_list<key_type> list,
+                     real                            m,
+                     hasher                          h,
+                     allocator                       a)
       : flat_set(list, m, h, equality{}, a) {}
 
-  flat_set(std::initializer_list<key_type> list,
-           size_type                       s,
-           real                            m,
-           hasher                          h = {},
-           equality                        e = {},
-           allocator                       a = {})
+  constexpr flat_set(std::initializer_list<key_type> list,
+                     size_type                       s,
+                     real                            m,
+                     hasher                          h = {},
+                     equality                        e = {},
+                     allocator                       a = {})
       : flat_set(std::max(s, std::ranges::size(list)), m, h, e, a) {
     for (const auto& k : list)
       nocheck_static_insert(k);
   }
 
-  flat_set(std::initializer_list<key_type> list,
-           size_type                       s,
-           real                            m,
-           allocator                       a)
+  constexpr flat_set(std::initializer_list<key_type> list,
+                     size_type                       s,
+                     real                            m,
+                     allocator                       a)
       : flat_set(list, s, m, hasher{}, equality{}, a) {}
 
-  flat_set(std::initializer_list<key_type> list,
-           size_type                       s,
-           real                            m,
-           hasher                          h,
-           allocator                       a)
+  constexpr flat_set(std::initializer_list<key_type> list,
+                     size_type                       s,
+                     real                            m,
+                     hasher                          h,
+                     allocator                       a)
       : flat_set(list, s, m, h, equality{}, a) {}
 
   /// Checks if the set contains zero elements.
-  bool empty() const noexcept { return base::empty(); }
+  constexpr bool empty() const noexcept { return base::empty(); }
 
   /// Returns the count of inserted elements.
-  auto size() const noexcept { return base::size(); }
+  constexpr auto size() const noexcept { return base::size(); }
 
   /// Returns the maximum number of storable elements in the current table.
   /// The capacity is doubled when the the load factor exceeds
   /// the maximum load factor.
-  auto capacity() const noexcept { return base::capacity(); }
+  constexpr auto capacity() const noexcept { return base::capacity(); }
 
   /// Returns the current load factor of the set.
   /// The load factor is the quotient of size and capacity.
-  auto load_factor() const noexcept { return base::load_factor(); }
+  constexpr auto load_factor() const noexcept { return base::load_factor(); }
 
   /// Returns the maximum load factor the set is allowed to have before
   /// rehashing all elements with a bigger capacity.
-  auto max_load_factor() const noexcept { return base::max_load_factor(); }
+  constexpr auto max_load_factor() const noexcept {
+    return base::max_load_factor();
+  }
 
   /// Sets the maximum load factor the set is allowed to have before
   /// rehashing all elements with a bigger capacity.
   /// Setting the maximum load factor to smaller values, may trigger a
   /// reallocation and rehashing of all contained keys.
-  void set_max_load_factor(real x) { base::set_max_load_factor(x); }
+  constexpr void set_max_load_factor(real x) { base::set_max_load_factor(x); }
+
+  /// Returns the minimum load factor below which the set is shrunk after
+  /// removing an element by its key. Zero means no automatic shrinking.
+  constexpr auto min_load_factor() const noexcept {
+    return base::min_load_factor();
+  }
+
+  /// Sets the minimum load factor for automatic shrinking. It has to be less
+  /// than a quarter of the maximum load factor. This margin prevents the set
+  /// from thrashing between growing and shrinking. Removing elements through
+  /// iterators never shrinks the set to keep other iterators valid.
+  constexpr void set_min_load_factor(real x) { base::set_min_load_factor(x); }
+
+  /// Returns a constant reference to the hasher, e.g. to read its seed.
+  constexpr const auto& hash_function() const noexcept { return base::hash; }
+
+  /// Returns how often the seed of the hasher has been replaced, either by
+  /// calling 'reseed', by loading a table with another seed, or automatically
+  /// because of detected hash flooding.
+  /// @see seeded_hash
+  constexpr auto reseed_count() const noexcept { return base::reseed_count(); }
+
+  /// Replaces the seed of the hasher by a new random seed and rehashes all
+  /// elements. In this case, all iterators and pointers become invalid.
+  constexpr void reseed() requires generic::seeded_hasher<hasher> {
+    base::reseed_and_rehash();
+  }
+
+  /// Returns the maximal probe sequence length of elements in the set or zero
+  /// if it is unbounded. @see set_psl_limit
+  constexpr auto psl_limit() const noexcept { return base::psl_limit(); }
+
+  /// Bounds the probe sequence length of all elements by the given value.
+  /// Insertions that would exceed the limit reseed the hasher or grow the
+  /// table instead. This way, every lookup inspects at most the given count of
+  /// slots. Zero removes the bound. Throws 'std::overflow_error' if the limit
+  /// cannot be kept without wasting memory, e.g. for too many equal hashes.
+  constexpr void set_psl_limit(psl_type x) { base::set_psl_limit(x); }
+
+  /// Returns the largest probe sequence length of all elements.
+  constexpr auto max_psl() const noexcept { return base::max_psl(); }
 
   /// Return an iterator to the beginning of the set.
-  auto begin() noexcept -> iterator { return base::table.begin(); }
+  constexpr auto begin() noexcept -> iterator { return base::table.begin(); }
 
   /// Return a constant iterator to the beginning of the set.
-  auto begin() const noexcept -> const_iterator { return base::table.begin(); }
+  constexpr auto begin() const noexcept -> const_iterator {
+    return base::table.begin();
+  }
 
   /// Return an iterator to the end of the set.
-  auto end() noexcept -> iterator { return base::table.end(); }
+  constexpr auto end() noexcept -> iterator { return base::table.end(); }
 
   /// Return a constant iterator to the end of the set.
-  auto end() const noexcept -> const_iterator { return base::table.end(); }
+  constexpr auto end() const noexcept -> const_iterator {
+    return base::table.end();
+  }
 
   /// Returns a constant reference to the underlying table.
   /// Mainly used for debugging and logging.
-  const auto& data() const noexcept { return base::table; }
+  constexpr const auto& data() const noexcept { return base::table; }
 
   /// Checks if an element has already been inserted into the map.
-  bool contains(const key_type& key) const noexcept {
+  constexpr bool contains(const key_type& key) const noexcept {
     return base::contains(key);
   }
 
+  /// Checks if an element has already been inserted into the set without
+  /// writing to shared memory. With the 'seqlock' policy, this may be called
+  /// by multiple threads while a single thread modifies the set.
+  bool optimistic_contains(const key_type& key) const noexcept  //
+      requires std::is_trivially_copyable_v<key_type> {
+    return base::optimistic_read(
+        key, [](const auto&, size_type, bool found) { return found; });
+  }
+
+  /// Frees all tables that have been retired by the synchronization policy.
+  /// Only call this when no concurrent reader is active.
+  void reclaim() noexcept  //
+      requires requires(synchronization s) { s.reclaim(); } {
+    base::sync.reclaim();
+  }
+
   /// Creates an iterator pointing to the given key.
   /// If this is not possible, returns the end iterator.
-  auto lookup(const key_type& key) noexcept -> iterator {
+  constexpr auto lookup(const key_type& key) noexcept -> iterator {
     return base::lookup(key);
   }
 
   /// Creates a constant iterator pointing to the given key.
   /// If this is not possible, return the end iterator. @see lookup
-  auto lookup(const key_type& key) const noexcept -> const_iterator {
+  constexpr auto lookup(const key_type& key) const noexcept -> const_iterator {
+    return base::lookup(key);
+  }
+
+  /// Returns the given key together with the value of the hasher for it.
+  /// The overloads taking such a key do not call the hasher. @see hashed_key
+  constexpr auto hashed(const key_type& key) const noexcept
+      -> hashed_key<key_type> {
+    return base::hashed(key);
+  }
+
+  /// The returned reference to a temporary key would dangle.
+  void hashed(key_type&&) const = delete;
+
+  /// Does the same as 'contains' without calling the hasher.
+  constexpr bool contains(const hashed_key<key_type>& key) const noexcept {
+    return base::contains(key);
+  }
+
+  /// Does the same as 'lookup' without calling the hasher.
+  constexpr auto lookup(const hashed_key<key_type>& key) noexcept -> iterator {
+    return base::lookup(key);
+  }
+
+  /// Does the same as 'lookup' without calling the hasher.
+  constexpr auto lookup(const hashed_key<key_type>& key) const noexcept
+      -> const_iterator {
     return base::lookup(key);
   }
 
   /// Checks if an element has already been inserted into the map.
-  bool operator()(const key_type& key) const noexcept {
+  constexpr bool operator()(const key_type& key) const noexcept {
     return base::contains(key);
   }
 
@@ -293,60 +441,202 @@ class flat_set : private flat_set_base<Key, Hasher, Equality, Allocator> {
   /// elements into it, and swapping its content with the actual table.
   /// In this case, all iterators and pointers become invalid.
   /// If the given size is smaller than the current table size, nothing happens.
-  void reserve_capacity(size_type count) { base::reserve_capacity(count); }
+  constexpr void reserve_capacity(size_type count) {
+    base::reserve_capacity(count);
+  }
 
   /// Reserves enough memory in the underlying table such that 'count' elements
   /// could be inserted without implicitly triggering a rehash with respect to
   /// the current maximum allowed load factor. @see reserve_capacity
-  void reserve(size_type count) { base::reserve(count); }
+  constexpr void reserve(size_type count) { base::reserve(count); }
+
+  /// Rehashes all elements into the smallest table which 'reserve' would
+  /// choose for the current size to give back unused memory.
+  /// In this case, all iterators and pointers become invalid.
+  constexpr void shrink_to_fit() { base::shrink_to_fit(); }
+
+  /// Swaps the content of both sets without copying or moving elements.
+  constexpr void swap(flat_set& other) noexcept { base::swap(other); }
+
+  /// Calls the given function for every element of the set in the form of a
+  /// constant reference. With a parallel execution policy, the table is
+  /// divided into contiguous chunks of slots which are processed by multiple
+  /// threads. In this case, 'f' has to be safe to be called concurrently.
+  template <generic::execution_policy Policy, typename F>
+  void for_each(Policy&& policy, F&& f) const {
+    base::for_each(policy, f);
+  }
+
+  /// Transforms every element of the set and reduces the results together with
+  /// the initial value. For parallel execution policies, 'reduce' has to be
+  /// associative. The order of elements is the order of the table slots.
+  template <generic::execution_policy Policy,
+            typename T,
+            typename Reduce,
+            typename Transform>
+  auto transform_reduce(Policy&&  policy,
+                        T         init,
+                        Reduce    reduce,
+                        Transform transform) const -> T {
+    return base::transform_reduce(policy, std::move(init), std::move(reduce),
+                                  std::move(transform));
+  }
 
   /// Clears all the contents of the set without changing its capacitcy.
-  void clear() { base::clear(); }
+  constexpr void clear() { base::clear(); }
+
+  /// Clears all the contents of the set with respect to the given execution
+  /// policy. For parallel policies, elements are destroyed by multiple threads.
+  template <generic::execution_policy Policy>
+  void clear(Policy&& policy) { base::clear(policy); }
+
+  /// Maps all pages of the table in parallel by touching them. Call this after
+  /// 'reserve' to keep page faults out of the first insertions and lookups.
+  void prefault() { base::prefault(execution::par); }
+
+  template <generic::execution_policy Policy>
+  void prefault(Policy&& policy) { base::prefault(policy); }
+
+  /// Hands all elements together with their memory to a background thread
+  /// which destroys them in parallel. The set is left empty with minimal
+  /// capacity and can be used right away. The returned future becomes ready
+  /// when the old elements have been destroyed. Use this to avoid the latency
+  /// of tearing down huge sets with non-trivial elements.
+  /// With a seqlock, the old table is retired until 'reclaim' instead.
+  auto dispose_async() -> std::future<void> { return base::dispose_async(); }
+
+  /// Returns a copy of the allocator used by the set.
+  constexpr auto get_allocator() const noexcept -> allocator {
+    return base::table.get_allocator();
+  }
+
+  /// Forgets all elements and the memory of the set without destroying and
+  /// deallocating them. Afterwards, the set is empty with minimal capacity.
+  /// This is meant for arena allocators, such as 'std::pmr' allocators with a
+  /// 'std::pmr::monotonic_buffer_resource', whose memory is released at once.
+  /// Elements that own further memory must have allocated it from the arena.
+  constexpr void release() { base::release(); }
+
+  /// Returns the bytes allocated by the set. All slots of the table are taken
+  /// into account and not only the occupied ones. Memory owned by the elements
+  /// themselves, like the buffer of a string, is not included.
+  auto memory_usage() const noexcept -> robin_hood::memory_usage {
+    return base::memory_usage();
+  }
+
+  /// Returns the bytes allocated by the set and its elements. The given
+  /// function is called with a reference to every key and has to return
+  /// the count of bytes owned by it.
+  template <typename F>
+  auto memory_usage(F&& owned) const -> robin_hood::memory_usage {
+    return base::memory_usage(std::forward<F>(owned));
+  }
+
+  /// Writes the set to the given binary stream. Together with all keys, the
+  /// layout of the table is stored such that 'load' is able to put them back
+  /// into their slots without rehashing. Keys are written by the given
+  /// serializer. @see serializer
+  template <generic::serializer<key_type> KeySerializer = serializer<key_type>>
+  void save(std::ostream& os, const KeySerializer& keys = {}) const {
+    base::serialize(os, [&](std::ostream& os, size_type index) {
+      keys.write(os, base::table.key(index));
+    });
+  }
+
+  /// Replaces the content of the set by the one written by 'save'. The set
+  /// has to use the same hash function. Otherwise, or if the stream does not
+  /// contain a valid set of the given key type, an exception of type
+  /// 'std::invalid_argument' is thrown and the set stays unchanged.
+  template <generic::serializer<key_type> KeySerializer = serializer<key_type>>
+  void load(std::istream& is, const KeySerializer& keys = {}) {
+    base::deserialize(is, [&](std::istream& is, auto& table, size_type index) {
+      table.construct_key(index, keys.read(is));
+    });
+  }
 
   /// Statically inserts a given element into the set without reallocation and
   /// rehashing. If a reallocation would take place, the functions throws an
   /// exception 'std::overlow_error'. If the key has already been inserted, the
   /// function throws an exception of type 'std::invalid_argument'.
   template <generic::forwardable<key_type> K>
-  void static_insert(K&& key) {
+  constexpr void static_insert(K&& key) {
     base::static_insert_key(std::forward<K>(key));
   }
 
   /// Statically inserts a given element into the set without reallocation and
   /// rehashing. If a reallocation would take place or if the key has already
   /// been inserted, the function does nothing.
+  /// Returns an iterator to the element and the status of the insertion.
   template <generic::forwardable<key_type> K>
-  void try_static_insert(K&& key) {
-    base::try_static_insert_key(std::forward<K>(key));
+  constexpr auto try_static_insert(K&& key)
+      -> std::pair<iterator, insert_status> {
+    return base::insert_result(
+        base::try_static_insert_key(std::forward<K>(key)));
   }
 
   /// Statically inserts a given element into the set without reallocation and
   /// rehashing and without checking for overload. The function assumes that
   /// after insertion the maximum load factor will not be exceeded. If the key
   /// has already been inserted, the function does nothing.
+  /// Returns an iterator to the element and the status of the insertion.
   template <generic::forwardable<key_type> K>
-  void nocheck_static_insert(K&& key) {
-    base::nocheck_static_insert_key(std::forward<K>(key));
+  constexpr auto nocheck_static_insert(K&& key)
+      -> std::pair<iterator, insert_status> {
+    return base::insert_result(
+        base::nocheck_static_insert_key(std::forward<K>(key)));
   }
 
   /// Inserts a given element into the set with possible reallocation and
   /// rehashing. If the element has already been inserted, the
   /// function throws an exception of type 'std::invalid_argument'.
   template <generic::forwardable<key_type> K>
-  void insert(K&& key) {
+  constexpr void insert(K&& key) {
     base::insert_key(std::forward<K>(key));
   }
 
   /// Inserts a given element into the set with possible reallocation and
   /// rehashing. If the key has already been inserted, nothing is done.
+  /// Returns an iterator to the element and the status of the insertion.
   template <generic::forwardable<key_type> K>
-  void try_insert(K&& key) {
-    base::try_insert_key(std::forward<K>(key));
+  constexpr auto try_insert(K&& key)
+      -> std::pair<iterator, insert_status> {
+    return base::insert_result(
+        base::try_insert_key(std::forward<K>(key)));
+  }
+
+  /// Does the same as 'insert' without calling the hasher for the lookup.
+  constexpr void insert(const hashed_key<key_type>& key) {
+    const auto [index, status] =
+        base::try_insert_key(key.key, base::hash_of(key));
+    if (status != insert_status::inserted) base::fail(status);
+  }
+
+  /// Does the same as 'try_insert' without calling the hasher for the lookup.
+  constexpr auto try_insert(const hashed_key<key_type>& key)
+      -> std::pair<iterator, insert_status> {
+    return base::insert_result(
+        base::try_insert_key(key.key, base::hash_of(key)));
+  }
+
+  /// Does the same as 'insert' for a key whose value of the hasher has already
+  /// been computed by 'hashed'. The key is moved into the set.
+  constexpr void insert(key_type&& key, const hashed_key<key_type>& hashed) {
+    const auto [index, status] =
+        base::try_insert_key(std::move(key), base::hash_of(hashed));
+    if (status != insert_status::inserted) base::fail(status);
+  }
+
+  /// Does the same as 'try_insert' for a key whose value of the hasher has
+  /// already been computed. The key is only moved if it is inserted.
+  constexpr auto try_insert(key_type&& key, const hashed_key<key_type>& hashed)
+      -> std::pair<iterator, insert_status> {
+    return base::insert_result(
+        base::try_insert_key(std::move(key), base::hash_of(hashed)));
   }
 
   /// Inserts elements into the set by using the given input range.
   template <generic::input_range<key_type> T>
-  void insert(const T& data) {
+  constexpr void insert(const T& data) {
     reserve(std::ranges::size(data) + size());
     for (const auto& k : data)
       nocheck_static_insert(k);
@@ -356,26 +646,36 @@ class flat_set : private flat_set_base<Key, Hasher, Equality, Allocator> {
   /// itself. This function can be chained. No exception is thrown if the given
   /// element already exists.
   template <generic::forwardable<key_type> K>
-  auto operator[](K&& key) -> flat_set& {
+  constexpr auto operator[](K&& key) -> flat_set& {
     try_insert(std::forward<K>(key));
     return *this;
   }
 
   /// Removes the given element from the set. If there is no such element,
   /// throws an exception of type 'std::invalid_argument'.
-  void remove(const key_type& key) { base::remove(key); }
+  constexpr void remove(const key_type& key) { base::remove(key); }
 
   /// Removes the given element from the set.
   /// If there is no such element, nothing is done.
-  void try_remove(const key_type& key) { base::try_remove(key); }
+  constexpr void try_remove(const key_type& key) { base::try_remove(key); }
+
+  /// Does the same as 'remove' without calling the hasher.
+  constexpr void remove(const hashed_key<key_type>& key) {
+    base::remove(key.key, base::hash_of(key));
+  }
+
+  /// Does the same as 'try_remove' without calling the hasher.
+  constexpr void try_remove(const hashed_key<key_type>& key) {
+    base::try_remove(key.key, base::hash_of(key));
+  }
 
   /// Removes the element pointed to by the given iterator.
   /// This functions assumes the iterator is pointing to an existing element.
-  void remove(iterator it) { base::remove(it); }
+  constexpr void remove(iterator it) { base::remove(it); }
 
   /// Removes the element pointed to by the given iterator.
   /// This functions assumes the iterator is pointing to an existing element.
-  void remove(const_iterator it) { base::remove(it); }
+  constexpr void remove(const_iterator it) { base::remove(it); }
 };
 
 TEMPLATE
@@ -393,11 +693,11 @@ template <generic::key                       Key,
           generic::hasher<Key>               Hasher    = std::hash<Key>,
           generic::equivalence_relation<Key> Equality  = std::equal_to<Key>,
           generic::allocator                 Allocator = std::allocator<Key>>
-inline auto auto_flat_set(size_t           size,
-                          const Hasher&    hash  = {},
-                          const Equality&  equal = {},
-                          const Allocator& alloc = {}) {
-  return FLAT_SET(size, hash, equal, alloc);
+constexpr auto auto_flat_set(size_t           size,
+                             const Hasher&    hash  = {},
+                             const Equality&  equal = {},
+                             const Allocator& alloc = {}) {
+  return flat_set<Key, Hasher, Equality, Allocator>(size, hash, equal, alloc);
 }
 
 template <std::ranges::input_range                       T,
@@ -407,10 +707,10 @@ template <std::ranges::input_range                       T,
               Equality = std::equal_to<std::ranges::range_value_t<T>>,
           generic::allocator Allocator =
               std::allocator<std::ranges::range_value_t<T>>>
-inline auto auto_flat_set(const T&         list,
-                          const Hasher&    hash  = {},
-                          const Equality&  equal = {},
-                          const Allocator& alloc = {}) {
+constexpr auto auto_flat_set(const T&         list,
+                             const Hasher&    hash  = {},
+                             const Equality&  equal = {},
+                             const Allocator& alloc = {}) {
   return flat_set<std::ranges::range_value_t<T>, Hasher, Equality, Allocator>(
       list, hash, equal, alloc);
 }
@@ -0,0 +1,222 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+//
+#include <lyrahgames/robin_hood/hash.hpp>
+#include <lyrahgames/robin_hood/meta.hpp>
+//
+#include <lyrahgames/robin_hood/detail/multiply.hpp>
+#include <lyrahgames/robin_hood/detail/raise.hpp>
+
+namespace lyrahgames::robin_hood {
+
+/// \class frozen_map frozen_map.hpp
+/// Immutable map of a fixed set of elements that is built without collisions
+/// in constant expressions, e.g. for keywords or names of enumerators.
+/// It is constructed by the hash-and-displace scheme. The hash value of every
+/// key selects a bucket. Every bucket stores a seed which places all of its
+/// keys on distinct free slots of the table. Buckets with many keys are placed
+/// first while the table is still empty. Hence, a lookup computes the hash
+/// value once, reads a single seed and a single slot, and compares one key.
+/// The hasher needs to be usable in constant expressions and has to provide
+/// well-distributed high bits, like all hashers of 'hash.hpp' do.
+template <generic::key                       Key,
+          typename Value,
+          size_t                             N,
+          generic::hasher<Key>               Hasher   = robin_hood::hash<Key>,
+          generic::equivalence_relation<Key> Equality = std::equal_to<Key>>
+class frozen_map {
+ public:
+  using key_type       = Key;
+  using mapped_type    = Value;
+  using value_type     = std::pair<key_type, mapped_type>;
+  using hasher         = Hasher;
+  using equality       = Equality;
+  using size_type      = size_t;
+  using seed_type      = uint32_t;
+  using index_type     = uint32_t;
+  using const_iterator = const value_type*;
+  using iterator       = const_iterator;
+
+  static_assert(N < std::numeric_limits<index_type>::max());
+
+  /// Count of slots. Every slot refers to an element. The maximum load factor
+  /// of 0.8 keeps the search for seeds of the last buckets short.
+  static constexpr size_type table_size = N + N / 4 + 1;
+  /// Count of buckets. Each of them contains two keys on average.
+  static constexpr size_type bucket_count = std::max(N / 2, size_t{1});
+
+  /// Constructs the map of the given elements. Throws an exception of type
+  /// 'std::invalid_argument' if keys are not unique or if the hash values of
+  /// different keys are equal. In constant expressions, this is reported as
+  /// a compile-time error.
+  constexpr explicit frozen_map(const std::array<value_type, N>& list,
+                                hasher                           h = {},
+                                equality                         e = {})
+      : elements{list}, hash{h}, equal{e} {
+    build();
+  }
+
+  constexpr explicit frozen_map(const value_type (&list)[N],
+                                hasher   h = {},
+                                equality e = {}) requires(N > 0)
+      : frozen_map(std::to_array(list), h, e) {}
+
+  static constexpr bool empty() noexcept { return N == 0; }
+
+  static constexpr auto size() noexcept { return N; }
+
+  /// Returns an iterator to the element with the given key.
+  /// If there is no such element, the end iterator is returned.
+  constexpr auto lookup(const key_type& key) const noexcept -> const_iterator {
+    if constexpr (N == 0) {
+      return end();
+    } else {
+      const auto& x = elements[indices[index(key)]];
+      return equal(x.first, key) ? &x : end();
+    }
+  }
+
+  constexpr bool contains(const key_type& key) const noexcept {
+    return lookup(key) != end();
+  }
+
+  /// Returns a constant reference to the mapped value of the given key. If no
+  /// such element exists, an exception of type std::invalid_argument is thrown.
+  constexpr auto operator()(const key_type& key) const -> const mapped_type& {
+    const auto it = lookup(key);
+    if (it != end()) return it->second;
+    detail::raise<std::invalid_argument>("Failed to find the given key.");
+  }
+
+  /// Elements are iterated in the order they were given at construction.
+  constexpr auto begin() const noexcept -> const_iterator {
+    return elements.data();
+  }
+
+  constexpr auto end() const noexcept -> const_iterator {
+    return elements.data() + N;
+  }
+
+  constexpr auto hash_function() const noexcept { return hash; }
+
+  constexpr auto key_eq() const noexcept { return equal; }
+
+ private:
+  static constexpr auto bucket(uint64_t h) noexcept -> size_type {
+    return detail::multiply(h, bucket_count).second;
+  }
+
+  static constexpr auto slot(uint64_t h, seed_type seed) noexcept
+      -> size_type {
+    return detail::multiply(detail::wyhash::hash(h, seed), table_size).second;
+  }
+
+  constexpr auto index(const key_type& key) const noexcept -> size_type {
+    const uint64_t h = hash(key);
+    return slot(h, seeds[bucket(h)]);
+  }
+
+  /// Assigns a seed to every bucket and the index of an element to every slot.
+  /// Slots without an element refer to the first one. The key comparison of
+  /// a lookup then fails because the first key lies at another slot.
+  constexpr void build() {
+    std::array<uint64_t, N>             hashes{};
+    std::array<size_type, N>            order{};
+    std::array<size_type, bucket_count> sizes{};
+    for (size_type i = 0; i < N; ++i) {
+      hashes[i] = hash(elements[i].first);
+      order[i]  = i;
+      ++sizes[bucket(hashes[i])];
+    }
+
+    // Keys of the same bucket become adjacent and large buckets come first.
+    std::sort(order.begin(), order.end(), [&](size_type i, size_type j) {
+      const auto p = bucket(hashes[i]);
+      const auto q = bucket(hashes[j]);
+      if (sizes[p] != sizes[q]) return sizes[p] > sizes[q];
+      return p < q;
+    });
+
+    std::array<bool, table_size> used{};
+    for (size_type first = 0; first < N;) {
+      const auto b    = bucket(hashes[order[first]]);
+      const auto last = first + sizes[b];
+      check_distinct(hashes, order, first, last);
+      seeds[b] = place(hashes, order, first, last, used);
+      first    = last;
+    }
+  }
+
+  /// Equal hash values of one bucket would be placed on the same slot
+  /// for every seed. So, the construction would never end.
+  constexpr void check_distinct(const std::array<uint64_t, N>&  hashes,
+                                const std::array<size_type, N>& order,
+                                size_type                       first,
+                                size_type                       last) const {
+    for (auto i = first; i < last; ++i) {
+      for (auto j = i + 1; j < last; ++j) {
+        if (hashes[order[i]] != hashes[order[j]]) continue;
+        if (equal(elements[order[i]].first, elements[order[j]].first))
+          detail::raise<std::invalid_argument>(
+              "Failed to construct frozen map with duplicate keys!");
+        detail::raise<std::invalid_argument>(
+            "Failed to construct frozen map with equal hash values!");
+      }
+    }
+  }
+
+  /// Searches the first seed that places all keys of the given range
+  /// of one bucket on free slots and marks these slots as used.
+  constexpr auto place(const std::array<uint64_t, N>&  hashes,
+                       const std::array<size_type, N>& order,
+                       size_type                       first,
+                       size_type                       last,
+                       std::array<bool, table_size>&   used) -> seed_type {
+    for (seed_type seed = 0; seed < std::numeric_limits<seed_type>::max();
+         ++seed) {
+      auto i = first;
+      for (; i < last; ++i) {
+        const auto s = slot(hashes[order[i]], seed);
+        if (used[s]) break;
+        used[s] = true;
+      }
+      if (i == last) {
+        for (auto j = first; j < last; ++j)
+          indices[slot(hashes[order[j]], seed)] = order[j];
+        return seed;
+      }
+      for (auto j = first; j < i; ++j)
+        used[slot(hashes[order[j]], seed)] = false;
+    }
+    detail::raise<std::invalid_argument>(
+        "Failed to find a seed for the frozen map!");
+  }
+
+  std::array<value_type, N>           elements;
+  std::array<seed_type, bucket_count> seeds{};
+  std::array<index_type, table_size>  indices{};
+  [[no_unique_address]] hasher        hash{};
+  [[no_unique_address]] equality      equal{};
+};
+
+/// Builds a frozen map of the given elements whose count is deduced.
+/// Typically, it is used to initialize a 'constexpr' variable.
+/// @see frozen_map
+template <generic::key                       Key,
+          typename Value,
+          generic::hasher<Key>               Hasher   = robin_hood::hash<Key>,
+          generic::equivalence_relation<Key> Equality = std::equal_to<Key>,
+          size_t                             N>
+constexpr auto make_frozen_map(const std::pair<Key, Value> (&list)[N],
+                               Hasher   h = {},
+                               Equality e = {}) {
+  return frozen_map<Key, Value, N, Hasher, Equality>(list, h, e);
+}
+
+}  // namespace lyrahgames::robin_hood
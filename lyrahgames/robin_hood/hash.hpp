@@ -0,0 +1,259 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+//
+#include <lyrahgames/robin_hood/detail/multiply.hpp>
+
+namespace lyrahgames::robin_hood {
+
+namespace detail {
+
+/// Types whose pointers may be used to read a sequence of single bytes.
+template <typename T>
+concept byte_like = std::same_as<T, char> || std::same_as<T, signed char> ||
+                    std::same_as<T, unsigned char> ||
+                    std::same_as<T, char8_t> || std::same_as<T, std::byte>;
+
+/// Hash functions for arbitrary bytes in the style of wyhash.
+/// All of them are based on the full 128-bit product of two 64-bit numbers
+/// whose halves are folded together. The results are well distributed in
+/// their low and their high bits and may be used with every mixer and
+/// capacity policy. Bytes given by character pointers can also be hashed
+/// in constant expressions.
+struct wyhash {
+  static constexpr uint64_t secret[] = {
+      0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull,
+      0x4d5a2da51de1aa47ull};
+
+  static constexpr auto mix(uint64_t x, uint64_t y) noexcept -> uint64_t {
+    const auto [low, high] = multiply(x, y);
+    return low ^ high;
+  }
+
+  template <byte_like Byte>
+  static constexpr auto byte(const Byte* p) noexcept -> uint64_t {
+    return static_cast<unsigned char>(p[0]);
+  }
+
+  /// Reads the given count of bytes as a number in native byte order.
+  /// Constant expressions cannot reinterpret memory by 'std::memcpy'.
+  /// So, the number is assembled byte by byte.
+  template <typename T, byte_like Byte>
+  static constexpr auto read(const Byte* p) noexcept -> uint64_t {
+    if (std::is_constant_evaluated()) {
+      uint64_t result = 0;
+      for (size_t i = 0; i < sizeof(T); ++i) {
+        const auto shift = (std::endian::native == std::endian::little)
+                               ? 8 * i
+                               : 8 * (sizeof(T) - 1 - i);
+        result |= byte(p + i) << shift;
+      }
+      return result;
+    }
+    T result;
+    std::memcpy(&result, p, sizeof(result));
+    return result;
+  }
+
+  template <byte_like Byte>
+  static constexpr auto read8(const Byte* p) noexcept -> uint64_t {
+    return read<uint64_t>(p);
+  }
+
+  template <byte_like Byte>
+  static constexpr auto read4(const Byte* p) noexcept -> uint64_t {
+    return read<uint32_t>(p);
+  }
+
+  /// Reads up to three bytes without branching on their count.
+  template <byte_like Byte>
+  static constexpr auto read3(const Byte* p, size_t n) noexcept -> uint64_t {
+    return (byte(p) << 16) | (byte(p + (n >> 1)) << 8) | byte(p + n - 1);
+  }
+
+  /// Hashes a single number with one multiplication.
+  /// The seed determines the multiplier.
+  static constexpr auto hash(uint64_t x, uint64_t seed = 0) noexcept
+      -> uint64_t {
+    return mix(x ^ secret[0], seed ^ secret[1]);
+  }
+
+  /// Hashes the given count of bytes.
+  static auto hash(const void* data, size_t n, uint64_t seed = 0) noexcept
+      -> uint64_t {
+    return hash(static_cast<const unsigned char*>(data), n, seed);
+  }
+
+  /// Character pointers allow to hash bytes in constant expressions.
+  template <byte_like Byte>
+  static constexpr auto hash(const Byte* p,
+                             size_t      n,
+                             uint64_t    seed = 0) noexcept -> uint64_t {
+    seed ^= mix(seed ^ secret[0], secret[1]);
+    uint64_t a, b;
+    if (n <= 16) {
+      if (n >= 4) {
+        const auto offset = (n >> 3) << 2;
+        a = (read4(p) << 32) | read4(p + offset);
+        b = (read4(p + n - 4) << 32) | read4(p + n - 4 - offset);
+      } else if (n > 0) {
+        a = read3(p, n);
+        b = 0;
+      } else {
+        a = b = 0;
+      }
+    } else {
+      auto i = n;
+      if (i > 48) {
+        auto seed1 = seed;
+        auto seed2 = seed;
+        do {
+          seed  = mix(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+          seed1 = mix(read8(p + 16) ^ secret[2], read8(p + 24) ^ seed1);
+          seed2 = mix(read8(p + 32) ^ secret[3], read8(p + 40) ^ seed2);
+          p += 48;
+          i -= 48;
+        } while (i > 48);
+        seed ^= seed1 ^ seed2;
+      }
+      while (i > 16) {
+        seed = mix(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+        p += 16;
+        i -= 16;
+      }
+      a = read8(p + i - 16);
+      b = read8(p + i - 8);
+    }
+    const auto [low, high] = multiply(a ^ secret[1], b ^ seed);
+    return mix(low ^ secret[0] ^ n, high ^ secret[1]);
+  }
+};
+
+/// Returns a new unpredictable seed for seeded hashers. The generator is
+/// seeded once by 'std::random_device' and is safe to be used concurrently.
+inline auto random_seed() -> uint64_t {
+  static std::atomic<uint64_t> state{
+      (uint64_t(std::random_device{}()) << 32) ^ std::random_device{}()};
+  return wyhash::hash(state.fetch_add(0x9e3779b97f4a7c15ull));
+}
+
+}  // namespace detail
+
+/// \class hash hash.hpp
+/// Fast hash functions for common key types which satisfy 'generic::hasher'.
+/// The primary template hashes the object representation of types whose
+/// equal values always consist of equal bytes, such as integers, enums,
+/// pointers, and structs of them without padding. Numbers of up to eight bytes
+/// are hashed with a single multiplication and larger objects in the style of
+/// wyhash. Further specializations are given for strings and byte spans.
+template <typename T>
+struct hash {
+  static_assert(std::has_unique_object_representations_v<T>,
+                "Equal values of the given type may consist of different "
+                "bytes. Use 'pod_hash' if this can be ruled out.");
+
+  constexpr auto operator()(const T& x) const noexcept -> size_t {
+    return seeded(x);
+  }
+
+  static constexpr auto seeded(const T& x, uint64_t seed = 0) noexcept
+      -> size_t {
+    if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+      return detail::wyhash::hash(uint64_t(x), seed);
+    } else if constexpr (sizeof(T) <= sizeof(uint64_t) &&
+                         std::is_trivially_copyable_v<T>) {
+      uint64_t bits = 0;
+      std::memcpy(&bits, &x, sizeof(T));
+      return detail::wyhash::hash(bits, seed);
+    } else {
+      return detail::wyhash::hash(&x, sizeof(T), seed);
+    }
+  }
+};
+
+/// Hashes the object representation of trivially copyable types, like
+/// structs of floating-point numbers. Use it only if equal values always
+/// consist of equal bytes. This is not the case for padding bytes or for
+/// the positive and negative zero of floating-point numbers.
+template <typename T>
+struct pod_hash {
+  static_assert(std::is_trivially_copyable_v<T>);
+
+  auto operator()(const T& x) const noexcept -> size_t { return seeded(x); }
+
+  static auto seeded(const T& x, uint64_t seed = 0) noexcept -> size_t {
+    return detail::wyhash::hash(&x, sizeof(T), seed);
+  }
+};
+
+/// Strings and string views of the same characters get the same hash value.
+template <>
+struct hash<std::string_view> {
+  constexpr auto operator()(const std::string_view& x) const noexcept
+      -> size_t {
+    return seeded(x);
+  }
+
+  static constexpr auto seeded(const std::string_view& x,
+                               uint64_t                seed = 0) noexcept
+      -> size_t {
+    return detail::wyhash::hash(x.data(), x.size(), seed);
+  }
+};
+
+template <>
+struct hash<std::string> {
+  constexpr auto operator()(const std::string& x) const noexcept -> size_t {
+    return seeded(x);
+  }
+
+  static constexpr auto seeded(const std::string& x, uint64_t seed = 0) noexcept
+      -> size_t {
+    return detail::wyhash::hash(x.data(), x.size(), seed);
+  }
+};
+
+template <>
+struct hash<std::span<const std::byte>> {
+  constexpr auto operator()(const std::span<const std::byte>& x) const noexcept
+      -> size_t {
+    return seeded(x);
+  }
+
+  static constexpr auto seeded(
+      const std::span<const std::byte>& x,
+      uint64_t                          seed = 0) noexcept -> size_t {
+    return detail::wyhash::hash(x.data(), x.size(), seed);
+  }
+};
+
+/// \class seeded_hash hash.hpp
+/// Hasher whose values depend on a secret seed. Every hasher starts with a new
+/// unpredictable seed. So, an attacker is not able to craft keys that collide
+/// in the table. Flat containers with a seeded hasher automatically replace
+/// the seed by calling 'reseed' and rehash their elements if an insertion
+/// reveals an unusually long probe sequence at a low load factor.
+/// The base hasher has to provide a static function 'seeded(key, seed)',
+/// like all hashers in this file do.
+template <typename T, typename Base = robin_hood::hash<T>>
+struct seeded_hash {
+  constexpr auto operator()(const T& x) const noexcept -> size_t {
+    return Base::seeded(x, seed);
+  }
+
+  /// Sets a new seed. Hash values of former seeds become invalid.
+  void reseed(uint64_t s) noexcept { seed = s; }
+
+  uint64_t seed = detail::random_seed();
+};
+
+}  // namespace lyrahgames::robin_hood
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+
+namespace lyrahgames::robin_hood {
+
+/// \class hashed_key hashed_key.hpp
+/// Reference to a key together with the value its hasher returns for it.
+/// Lookups, insertions, and removals of the flat containers accept it instead
+/// of the key itself and do not call their hasher again. This pays off for
+/// expensive hash functions, e.g. of long strings, whose values are already
+/// needed elsewhere, e.g. for sharding. The value must stem from a hasher
+/// equal to the one of the container. Use 'hashed' of the container to create
+/// it. It also records the reseed count of the container. Seeded containers
+/// may reseed automatically, e.g. on hash flooding. Afterwards, the stored
+/// value is stale and the containers call their hasher again for this key.
+/// Insertions copy the referenced key. To move a key into a container instead,
+/// pass the key as rvalue together with its hashed key.
+template <typename Key>
+struct hashed_key {
+  const Key& key;
+  size_t     hash;
+  size_t     reseeds = 0;
+};
+
+}  // namespace lyrahgames::robin_hood
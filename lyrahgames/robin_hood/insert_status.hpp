@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+
+namespace lyrahgames::robin_hood {
+
+/// Outcome of an insertion into a flat container. The non-throwing insertion
+/// functions return it together with an iterator to the element. The
+/// throwing ones are layered on top of them and turn every outcome other
+/// than 'inserted' into an exception.
+enum class insert_status : uint8_t {
+  /// The element has been inserted.
+  inserted,
+  /// An element with the same key exists. The iterator points to it.
+  exists,
+  /// A static insertion would exceed the maximum load factor.
+  overloaded,
+  /// A static insertion would exceed the PSL limit.
+  psl_limit,
+};
+
+}  // namespace lyrahgames::robin_hood
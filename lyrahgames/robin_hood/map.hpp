@@ -14,8 +14,11 @@
 #include <lyrahgames/xstd/math.hpp>
 #include <lyrahgames/xstd/swap.hpp>
 //
+#include <lyrahgames/robin_hood/insert_status.hpp>
+#include <lyrahgames/robin_hood/memory_usage.hpp>
 #include <lyrahgames/robin_hood/meta.hpp>
 //
+#include <lyrahgames/robin_hood/detail/raise.hpp>
 #include <lyrahgames/robin_hood/detail/table.hpp>
 
 namespace lyrahgames::robin_hood {
@@ -317,8 +320,21 @@ class map {
 
   void clear();
 
+  /// Rehashes all elements into the smallest table which 'reserve' would
+  /// choose for the current size to give back unused memory.
+  /// In this case, all iterators and pointers become invalid.
   void shrink_to_fit();
 
+  /// Returns the bytes allocated by the map. All slots of the table are taken
+  /// into account and not only the occupied ones.
+  auto memory_usage() const noexcept -> robin_hood::memory_usage;
+
+  /// Returns the bytes allocated by the map and its elements. The given
+  /// function is called with the key and the value of every element and has
+  /// to return the count of bytes owned by them.
+  template <typename F>
+  auto memory_usage(F&& owned) const -> robin_hood::memory_usage;
+
   /// Output the inner state of the map by using the given output stream.
   /// This function should only be used for debugging.
   friend std::ostream& operator<<(std::ostream& os, const map& m) {
@@ -387,6 +403,13 @@ class map {
   template <generic::forward_reference<key_type> K>
   auto basic_insert(K&& key, size_type index, psl_type psl) -> size_type;
 
+  /// Statically inserts the given key without throwing. The returned status
+  /// tells whether the key has been inserted at the returned index, whether
+  /// it already exists at the returned index, or whether the map is
+  /// overloaded.
+  template <generic::forwardable<key_type> K>
+  auto try_static_insert_key(K&& key) -> std::pair<size_type, insert_status>;
+
   template <generic::forwardable<key_type> K>
   auto static_insert_key(K&& key) -> size_type;
 
@@ -116,6 +116,33 @@ void MAP::reserve(size_type count) {
   reserve_capacity(count);
 }
 
+TEMPLATE
+void MAP::shrink_to_fit() {
+  const auto count = size_type(std::ceil(load / max_load_ratio));
+  const auto size  = ceil_pow2(std::max(min_capacity, count));
+  if (size >= table.size) return;
+  basic_reallocate_and_rehash(size);
+}
+
+TEMPLATE
+auto MAP::memory_usage() const noexcept -> robin_hood::memory_usage {
+  return {.elements    = load,
+          .psl_bytes   = table.size * sizeof(psl_type),
+          .key_bytes   = table.size * sizeof(key_type),
+          .value_bytes = table.size * sizeof(mapped_type)};
+}
+
+TEMPLATE
+template <typename F>
+auto MAP::memory_usage(F&& owned) const -> robin_hood::memory_usage {
+  auto result = memory_usage();
+  for (size_t i = 0; i < table.size; ++i) {
+    if (!table.psl[i]) continue;
+    result.owned_bytes += owned(table.keys[i], table.values[i]);
+  }
+  return result;
+}
+
 TEMPLATE
 void MAP::set_max_load_factor(real x) {
   assert((x > 0) || (x < 1));
@@ -142,16 +169,27 @@ auto MAP::basic_insert(K&& key, size_type index, psl_type psl) -> size_type {
 
 TEMPLATE
 template <generic::forwardable<Key> K>
-auto MAP::static_insert_key(K&& key) -> size_type {
+auto MAP::try_static_insert_key(K&& key)
+    -> std::pair<size_type, insert_status> {
   // This makes sure key is constructed if it is not a direct forward reference.
   decltype(auto) k         = forward_construct<Key>(std::forward<K>(key));
   auto [index, psl, found] = basic_lookup_data(k);
-  if (found)
-    throw std::invalid_argument(
-        "Failed to insert element that already exists!");
-  if (overloaded())
-    throw std::overflow_error("Failed to statically insert given element!");
+  if (found) return {index, insert_status::exists};
+  if (overloaded()) return {index, insert_status::overloaded};
   basic_static_insert(std::forward<decltype(k)>(k), index, psl);
+  return {index, insert_status::inserted};
+}
+
+TEMPLATE
+template <generic::forwardable<Key> K>
+auto MAP::static_insert_key(K&& key) -> size_type {
+  const auto [index, status] = try_static_insert_key(std::forward<K>(key));
+  if (status == insert_status::exists)
+    detail::raise<std::invalid_argument>(
+        "Failed to insert element that already exists!");
+  if (status == insert_status::overloaded)
+    detail::raise<std::overflow_error>(
+        "Failed to statically insert given element!");
   return index;
 }
 
@@ -162,7 +200,7 @@ auto MAP::insert_key(K&& key) -> size_type {
   decltype(auto) k         = forward_construct<Key>(std::forward<K>(key));
   auto [index, psl, found] = basic_lookup_data(k);
   if (found)
-    throw std::invalid_argument(
+    detail::raise<std::invalid_argument>(
         "Failed to insert element that already exists!");
   index = basic_insert(std::forward<decltype(k)>(k), index, psl);
   return index;
@@ -217,11 +255,9 @@ inline void MAP::emplace(K&& key, arguments&&... args)  //
 TEMPLATE
 template <generic::forwardable<Key> K, generic::forwardable<Value> V>
 inline bool MAP::try_static_insert(K&& key, V&& value) {
-  try {
-    static_insert(std::forward<K>(key), std::forward<V>(value));
-  } catch (...) {
-    return false;
-  }
+  const auto [index, status] = try_static_insert_key(std::forward<K>(key));
+  if (status != insert_status::inserted) return false;
+  table.construct_value(index, std::forward<V>(value));
   return true;
 }
 
@@ -229,11 +265,9 @@ TEMPLATE
 template <generic::forwardable<Key> K>
 inline bool MAP::try_static_insert(K&& key)  //
     requires std::default_initializable<mapped_type> {
-  try {
-    static_insert(std::forward<K>(key));
-  } catch (...) {
-    return false;
-  }
+  const auto [index, status] = try_static_insert_key(std::forward<K>(key));
+  if (status != insert_status::inserted) return false;
+  table.construct_value(index);
   return true;
 }
 
@@ -267,7 +301,7 @@ TEMPLATE
 auto MAP::operator()(const key_type& key) -> mapped_type& {
   const auto [index, psl, found] = basic_lookup_data(key);
   if (found) return table.values[index];
-  throw std::invalid_argument("Failed to find the given key.");
+  detail::raise<std::invalid_argument>("Failed to find the given key.");
 }
 
 TEMPLATE
@@ -320,7 +354,9 @@ void MAP::basic_erase(size_type index) {
 TEMPLATE
 void MAP::erase(const key_type& key) {
   const auto [index, psl, found] = basic_lookup_data(key);
-  if (!found) throw std::invalid_argument("Failed to erase non-existing key!");
+  if (!found)
+    detail::raise<std::invalid_argument>(
+        "Failed to erase non-existing key!");
   basic_erase(index);
 }
 
@@ -0,0 +1,248 @@
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+//
+#if !defined(__linux__)
+#error "Mapped files are only available on Linux."
+#endif
+#include <fcntl.h>
+#include <unistd.h>
+//
+#include <lyrahgames/robin_hood/meta.hpp>
+//
+#include <lyrahgames/robin_hood/detail/memory_mapping.hpp>
+#include <lyrahgames/robin_hood/detail/raise.hpp>
+#include <lyrahgames/robin_hood/detail/traits.hpp>
+
+namespace lyrahgames::robin_hood {
+
+/// Header of a file that stores the table of a flat container for trivially
+/// copyable keys and values. The PSL, key, and value arrays follow exactly as
+/// they are laid out in memory. Every array starts at an offset that is a
+/// multiple of 'alignment'. Empty slots are filled with zero bytes. The seed
+/// of a readable seeded hasher is stored as well and zero for all others.
+struct mapped_file_header {
+  using size_type = typename detail::traits::size_type;
+  using psl_type  = typename detail::traits::psl_type;
+
+  /// The magic number reads "rhflat02" on little-endian machines. Files
+  /// written on machines with another byte order are rejected.
+  static constexpr uint64_t  magic_number = 0x32307461'6c666872ull;
+  static constexpr size_type alignment    = 64;
+
+  static constexpr auto align(size_type offset) noexcept -> size_type {
+    return (offset + alignment - 1) / alignment * alignment;
+  }
+
+  /// Returns the header of a table with the given size and element types.
+  /// A 'Value' of 'void' describes the table of a set.
+  template <typename Key, typename Value>
+  static auto make(size_type size, size_type load) noexcept
+      -> mapped_file_header {
+    mapped_file_header h{};
+    h.magic        = magic_number;
+    h.psl_bytes    = sizeof(psl_type);
+    h.key_bytes    = sizeof(Key);
+    h.key_align    = alignof(Key);
+    h.size         = size;
+    h.load         = load;
+    h.psl_offset   = align(sizeof(mapped_file_header));
+    h.key_offset   = align(h.psl_offset + size * sizeof(psl_type));
+    h.value_offset = align(h.key_offset + size * sizeof(Key));
+    h.file_bytes   = h.value_offset;
+    if constexpr (!std::is_void_v<Value>) {
+      h.value_bytes = sizeof(Value);
+      h.value_align = alignof(Value);
+      h.file_bytes  = align(h.value_offset + size * sizeof(Value));
+    }
+    return h;
+  }
+
+  /// Returns the largest table size with the given element types whose arrays
+  /// fit into the given count of bytes. Offsets of larger sizes would be
+  /// computed with wrapping arithmetic and could falsely seem to fit.
+  template <typename Key, typename Value>
+  static constexpr auto max_size(size_type bytes) noexcept -> size_type {
+    constexpr auto offset = align(sizeof(mapped_file_header));
+    size_type      slot   = sizeof(psl_type) + sizeof(Key);
+    if constexpr (!std::is_void_v<Value>) slot += sizeof(Value);
+    return (bytes < offset) ? 0 : (bytes - offset) / slot;
+  }
+
+  /// Returns the header at the beginning of the given bytes after checking
+  /// that it describes a valid table of the given element types which fits
+  /// into them. Otherwise, throws an exception of type 'std::invalid_argument'.
+  template <typename Key, typename Value>
+  static auto read(const std::byte* data, size_type bytes)
+      -> const mapped_file_header& {
+    if ((bytes < sizeof(mapped_file_header)) ||
+        (reinterpret_cast<const mapped_file_header*>(data)->magic !=
+         magic_number))
+      detail::raise<std::invalid_argument>(
+          "Failed to read mapped file without flat container header!");
+    const auto& h = *reinterpret_cast<const mapped_file_header*>(data);
+    const auto expected = make<Key, Value>(h.size, h.load);
+    if ((h.psl_bytes != expected.psl_bytes) ||
+        (h.key_bytes != expected.key_bytes) ||
+        (h.key_align != expected.key_align) ||
+        (h.value_bytes != expected.value_bytes) ||
+        (h.value_align != expected.value_align))
+      detail::raise<std::invalid_argument>(
+          "Failed to read mapped file of different element types!");
+    if ((h.size > max_size<Key, Value>(bytes)) ||
+        (h.psl_offset != expected.psl_offset) ||
+        (h.key_offset != expected.key_offset) ||
+        (h.value_offset != expected.value_offset) ||
+        (h.file_bytes != expected.file_bytes) || (h.file_bytes > bytes) ||
+        (h.size == 0) || (h.load > h.size))
+      detail::raise<std::invalid_argument>(
+          "Failed to read mapped file with corrupted table layout!");
+    return h;
+  }
+
+  uint64_t magic;
+  uint64_t psl_bytes;
+  uint64_t key_bytes;
+  uint64_t key_align;
+  uint64_t value_bytes;
+  uint64_t value_align;
+  uint64_t size;
+  uint64_t load;
+  uint64_t seed;
+  uint64_t psl_offset;
+  uint64_t key_offset;
+  uint64_t value_offset;
+  uint64_t file_bytes;
+};
+
+/// \class mapped_file mapped_file.hpp
+/// Read-only mapping of a whole file. Pages are shared with the page cache
+/// and with all other processes mapping the same file. They are only read
+/// from disk when they are accessed for the first time.
+class mapped_file {
+ public:
+  mapped_file() = default;
+
+  /// Maps the file of the given path. Throws an exception of type
+  /// 'std::system_error' if the file cannot be opened or mapped.
+  explicit mapped_file(const std::filesystem::path& path) {
+    const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) detail::memory_mapping::fail("Failed to open mapped file!");
+    mapping = detail::memory_mapping{fd, false};
+  }
+
+  auto data() const noexcept { return mapping.data(); }
+
+  auto size() const noexcept { return mapping.size(); }
+
+ private:
+  detail::memory_mapping mapping{};
+};
+
+namespace detail {
+
+/// Type of the values stored by a container or 'void' for sets.
+template <typename Container>
+struct mapped_value {
+  using type = void;
+};
+
+template <typename Container>
+requires requires { typename Container::mapped_type; }
+struct mapped_value<Container> {
+  using type = typename Container::mapped_type;
+};
+
+/// Writes the given array of table slots to the stream. Elements of empty
+/// slots are replaced by zero bytes such that no uninitialized memory is
+/// written to the file.
+template <typename T>
+void write_mapped_array(std::ostream&      os,
+                        const T*           data,
+                        const size_t*      psls,
+                        size_t             size,
+                        std::vector<char>& buffer) {
+  constexpr size_t chunk = 4096;
+  buffer.resize(chunk * sizeof(T));
+  for (size_t first = 0; first < size; first += chunk) {
+    const auto count = std::min(chunk, size - first);
+    std::fill(buffer.begin(), buffer.end(), 0);
+    for (size_t i = 0; i < count; ++i)
+      if (psls[first + i])
+        std::memcpy(&buffer[i * sizeof(T)], data + first + i, sizeof(T));
+    os.write(buffer.data(), count * sizeof(T));
+  }
+}
+
+inline void write_mapped_padding(std::ostream& os, size_t offset) {
+  const char zeros[mapped_file_header::alignment]{};
+  os.write(zeros, mapped_file_header::align(offset) - offset);
+}
+
+}  // namespace detail
+
+/// Writes the table of the given flat set or flat map to the given file such
+/// that it can be mapped into memory by 'mapped_flat_set' or
+/// 'mapped_flat_map' without any parsing or rehashing. Keys and values need
+/// to be trivially copyable. The table is written to a temporary file in the
+/// same directory which then atomically replaces the given file. Hence,
+/// processes that still map the old file keep their pages. Throws an
+/// exception of type 'std::system_error' if the file cannot be written.
+template <typename Container>
+requires std::is_trivially_copyable_v<typename Container::key_type>
+void save_mapped(const Container& c, const std::filesystem::path& path) {
+  using key_type    = typename Container::key_type;
+  using value_type  = typename detail::mapped_value<Container>::type;
+  const auto& table = c.data();
+  static_assert(std::is_void_v<value_type> ||
+                std::is_trivially_copyable_v<value_type>);
+
+  auto header =
+      mapped_file_header::make<key_type, value_type>(table.size, c.size());
+  if constexpr (generic::readable_seeded_hasher<typename Container::hasher>)
+    header.seed = c.hash_function().seed;
+  // Truncating a mapped file in place would make its mappers fault.
+  auto temporary = path;
+  temporary += ".tmp" + std::to_string(::getpid());
+  std::ofstream file{temporary, std::ios::binary | std::ios::trunc};
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  detail::write_mapped_padding(file, sizeof(header));
+  file.write(reinterpret_cast<const char*>(table.psls),
+             table.size * sizeof(*table.psls));
+  detail::write_mapped_padding(file, header.psl_offset +
+                                         table.size * sizeof(*table.psls));
+  std::vector<char> buffer{};
+  detail::write_mapped_array(file, table.keys, table.psls, table.size, buffer);
+  detail::write_mapped_padding(
+      file, header.key_offset + table.size * sizeof(key_type));
+  if constexpr (!std::is_void_v<value_type>) {
+    detail::write_mapped_array(file, table.values, table.psls, table.size,
+                               buffer);
+    detail::write_mapped_padding(
+        file, header.value_offset + table.size * sizeof(value_type));
+  }
+  file.close();
+  std::error_code error{};
+  if (!file) {
+    error = std::error_code{errno, std::generic_category()};
+  } else {
+    std::filesystem::rename(temporary, path, error);
+    if (!error) return;
+  }
+  std::error_code ignored{};
+  std::filesystem::remove(temporary, ignored);
+  detail::raise<std::system_error>(error, "Failed to write mapped file!");
+}
+
+}  // namespace lyrahgames::robin_hood
@@ -0,0 +1,99 @@
+#pragma once
+#include <filesystem>
+#include <stdexcept>
+#include <utility>
+//
+#include <lyrahgames/robin_hood/capacity.hpp>
+#include <lyrahgames/robin_hood/mapped_file.hpp>
+#include <lyrahgames/robin_hood/meta.hpp>
+#include <lyrahgames/robin_hood/mixer.hpp>
+//
+#include <lyrahgames/robin_hood/detail/mapped_base.hpp>
+#include <lyrahgames/robin_hood/detail/mapped_table.hpp>
+#include <lyrahgames/robin_hood/detail/raise.hpp>
+
+namespace lyrahgames::robin_hood {
+
+/// \class mapped_flat_map mapped_flat_map.hpp
+/// Read-only view on the table of a flat map that has been written to a file
+/// by 'save_mapped'. @see mapped_flat_set
+template <generic::key                       Key,
+          generic::value                     Value,
+          generic::hasher<Key>               Hasher   = std::hash<Key>,
+          generic::equivalence_relation<Key> Equality = std::equal_to<Key>,
+          typename Capacity                           = power_of_two_capacity,
+          typename Mixer                              = default_mixer<Capacity>>
+class mapped_flat_map
+    : private detail::mapped_base<detail::mapped_key_value_table<Key, Value>,
+                                  Hasher,
+                                  Equality,
+                                  Capacity,
+                                  Mixer> {
+ public:
+  using base = detail::mapped_base<detail::mapped_key_value_table<Key, Value>,
+                                   Hasher,
+                                   Equality,
+                                   Capacity,
+                                   Mixer>;
+  using key_type        = Key;
+  using mapped_type     = Value;
+  using hasher          = Hasher;
+  using equality        = Equality;
+  using capacity_policy = Capacity;
+  using mixer           = Mixer;
+  using size_type       = typename base::size_type;
+  using real            = typename base::real;
+  using const_iterator  = typename base::const_iterator;
+  using iterator        = const_iterator;
+
+  static_assert(std::is_trivially_copyable_v<key_type> &&
+                std::is_trivially_copyable_v<mapped_type>);
+
+  mapped_flat_map() = default;
+
+  /// Maps the given file. Throws an exception of type 'std::system_error' if
+  /// the file cannot be mapped and of type 'std::invalid_argument' if it does
+  /// not contain a flat map of the given types and hash function.
+  /// Seeded hashers whose seed can be read get the seed stored in the file.
+  explicit mapped_flat_map(const std::filesystem::path& path,
+                           hasher                       h = {},
+                           equality                     e = {})
+      : base(std::in_place_type<mapped_type>, path, h, e) {}
+
+  /// Checks if the map contains zero elements.
+  bool empty() const noexcept { return base::empty(); }
+
+  /// Returns the count of stored elements.
+  auto size() const noexcept { return base::size(); }
+
+  auto capacity() const noexcept { return base::capacity(); }
+
+  auto load_factor() const noexcept { return base::load_factor(); }
+
+  bool contains(const key_type& key) const noexcept {
+    return base::contains(key);
+  }
+
+  /// Returns an iterator to the element with the given key inside the
+  /// mapping. If there is no such element, the end iterator is returned.
+  auto lookup(const key_type& key) const noexcept -> const_iterator {
+    return base::lookup(key);
+  }
+
+  /// Returns a constant reference to the mapped value of the given key. If no
+  /// such element exists, an exception of type std::invalid_argument is thrown.
+  auto operator()(const key_type& key) const -> const mapped_type& {
+    const auto [index, psl, found] = base::lookup_data(key);
+    if (found) return base::table.value(index);
+    detail::raise<std::invalid_argument>("Failed to find the given key.");
+  }
+
+  auto begin() const noexcept -> const_iterator { return base::table.begin(); }
+
+  auto end() const noexcept -> const_iterator { return base::table.end(); }
+
+  /// Returns a constant reference to the underlying table.
+  const auto& data() const noexcept { return base::table; }
+};
+
+}  // namespace lyrahgames::robin_hood
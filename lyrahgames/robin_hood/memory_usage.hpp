@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+
+namespace lyrahgames::robin_hood {
+
+/// Memory statistics of a container returned by its 'memory_usage' member.
+/// Table arrays are accounted by their capacity and not by their size.
+/// Memory owned by the elements themselves is only known if the
+/// according hook has been given to 'memory_usage'.
+struct memory_usage {
+  /// Returns the bytes allocated by the container itself.
+  constexpr auto table_bytes() const noexcept {
+    return psl_bytes + key_bytes + value_bytes;
+  }
+
+  /// Returns the bytes allocated by the container and its elements.
+  constexpr auto total_bytes() const noexcept {
+    return table_bytes() + owned_bytes;
+  }
+
+  /// Returns the average count of bytes needed per inserted element.
+  /// For an empty container, the result is zero.
+  constexpr auto bytes_per_element() const noexcept {
+    return elements ? double(total_bytes()) / elements : 0.0;
+  }
+
+  size_t elements    = 0;
+  size_t psl_bytes   = 0;
+  size_t key_bytes   = 0;
+  size_t value_bytes = 0;
+  size_t owned_bytes = 0;
+};
+
+}  // namespace lyrahgames::robin_hood
@@ -1,6 +1,8 @@
 #pragma once
 #include <concepts>
+#include <cstdint>
 #include <iterator>
+#include <memory>
 #include <ranges>
 //
 #include <lyrahgames/xstd/forward.hpp>
@@ -32,6 +34,19 @@ concept hasher = irreducible<T>&& callable<F>&&
 template <typename T, typename F>
 concept hashability = hasher<F, T>;
 
+// Hashers whose values depend on a seed which can be replaced at runtime.
+template <typename F>
+concept seeded_hasher = requires(F f, uint64_t seed) {
+  f.reseed(seed);
+};
+
+// Seeded hashers whose current seed can be read. Tables that are saved to a
+// stream store it such that loading them restores the same hash values.
+template <typename F>
+concept readable_seeded_hasher = seeded_hasher<F> && requires(const F f) {
+  { f.seed } -> std::convertible_to<uint64_t>;
+};
+
 template <typename F, typename T>
 concept equivalence_relation =
     irreducible<T> && (std::equivalence_relation<F, T, T> ||
@@ -40,8 +55,33 @@ concept equivalence_relation =
 template <typename T, typename F>
 concept equivalence_relatable = equivalence_relation<F, T>;
 
+// Allocators are used through 'std::allocator_traits'. So, we only require the
+// minimal interface of the standard and the comparison used for propagation.
 template <typename A>
-concept allocator = true;
+concept allocator = std::copy_constructible<A> && std::equality_comparable<A> &&
+    requires(A a, typename std::allocator_traits<A>::size_type n) {
+  typename std::allocator_traits<A>::value_type;
+  a.deallocate(a.allocate(n), n);
+};
+
+// Allocators that are able to resize an allocation by possibly moving it.
+// The content of the old allocation is kept as if it would have been copied
+// bytewise. Tables of trivially copyable elements use this to grow in place.
+template <typename A>
+concept reallocatable_allocator = allocator<A> &&
+    requires(A a, typename std::allocator_traits<A>::pointer p, size_t n) {
+  { a.reallocate(p, n, n) } -> identical<decltype(p)>;
+};
+
+// Allocators that are able to hand out zero-initialized memory, typically
+// obtained from 'calloc' or from fresh pages of the kernel. Tables use this
+// for their PSL arrays so that untouched pages are never faulted in. If such
+// an allocator is able to reallocate, memory added by it must be zero, too.
+template <typename A>
+concept zeroing_allocator = allocator<A> &&
+    requires(A a, typename std::allocator_traits<A>::pointer p, size_t n) {
+  { a.allocate_zeroed(n) } -> identical<decltype(p)>;
+};
 
 template <typename T, typename K, typename V>
 concept pair_input_iterator = std::input_iterator<T>&&  //
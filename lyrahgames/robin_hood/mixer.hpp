@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace lyrahgames::robin_hood {
+
+// Hash mixers post-process the values of a hasher before they are reduced to
+// table indices. Weak hashers, like the identity that 'std::hash<int>' is for
+// many standard libraries, map structured keys to structured hash values and
+// lead to long clusters. A mixer spreads them over all bits.
+// If 'high_bits' is set, the table index is taken from the high bits of the
+// mixed value because only these depend on all bits of the input.
+
+/// Default mixer which passes through the hash values unchanged.
+struct identity_mixer {
+  static constexpr bool high_bits = false;
+
+  static constexpr auto mix(size_t hash) noexcept -> size_t { return hash; }
+};
+
+/// Multiplicative hashing with the golden ratio, also called Fibonacci
+/// hashing. It costs a single multiplication and only its high bits are
+/// well distributed.
+struct fibonacci_mixer {
+  static constexpr bool high_bits = true;
+
+  static constexpr auto mix(size_t hash) noexcept -> size_t {
+    return size_t(uint64_t(hash) * 0x9e3779b97f4a7c15ull);
+  }
+};
+
+/// Finalizer of MurmurHash3. All output bits depend on all input bits.
+/// It is slower than Fibonacci hashing but repairs even very weak hashers.
+struct fmix64_mixer {
+  static constexpr bool high_bits = false;
+
+  static constexpr auto mix(size_t hash) noexcept -> size_t {
+    auto x = uint64_t(hash);
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+    return size_t(x);
+  }
+};
+
+/// Mixer of the flat containers if none is given. Capacity policies which
+/// take indices from the high bits of hash values, like 'arbitrary_capacity',
+/// would put all small keys of identity hashers into the first slot and turn
+/// the table into a single cluster. For them, Fibonacci hashing is used.
+/// Otherwise, hash values are passed through unchanged.
+template <typename Capacity>
+using default_mixer = std::conditional_t<
+    requires { requires Capacity::high_bits; },
+    fibonacci_mixer,
+    identity_mixer>;
+
+}  // namespace lyrahgames::robin_hood
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <new>
+//
+#if !defined(__linux__)
+#error "The mmap allocator is only available on Linux."
+#endif
+#include <sys/mman.h>
+//
+#include <lyrahgames/robin_hood/detail/raise.hpp>
+
+namespace lyrahgames::robin_hood {
+
+/// \class mmap_allocator mmap_allocator.hpp
+/// Allocator which maps anonymous memory directly from the kernel.
+/// Additionally, it provides 'reallocate' based on 'mremap'. The flat
+/// containers use it to grow tables of trivially copyable elements in place
+/// without the transient second table of a usual rehash. Every allocation
+/// takes at least one page. So, this allocator is meant for huge tables.
+/// Its only state is the 'populate' flag. If it is set, all pages are
+/// populated by the kernel right away. Pages added by 'reallocate' are not
+/// populated. All instances compare equal because any of them is able to
+/// unmap the memory of another one.
+template <typename T>
+struct mmap_allocator {
+  using value_type = T;
+
+  mmap_allocator() noexcept = default;
+
+  /// If 'populate' is set, all pages are mapped by the kernel
+  /// during the allocation and will not fault on their first access.
+  explicit constexpr mmap_allocator(bool p) noexcept : populate{p} {}
+
+  template <typename U>
+  constexpr mmap_allocator(const mmap_allocator<U>& a) noexcept
+      : populate{a.populate} {}
+
+  static constexpr auto bytes(size_t n) noexcept { return n * sizeof(T); }
+
+  /// Maps zero-initialized memory for 'n' objects. Throws 'std::bad_alloc' if
+  /// the mapping fails and 'std::bad_array_new_length' if 'n' is too large.
+  auto allocate(size_t n) -> T* {
+    if (n == 0) return nullptr;
+    if (n > size_t(-1) / sizeof(T)) detail::raise<std::bad_array_new_length>();
+    const auto flags =
+        MAP_PRIVATE | MAP_ANONYMOUS | (populate ? MAP_POPULATE : 0);
+    const auto p =
+        mmap(nullptr, bytes(n), PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (p == MAP_FAILED) detail::raise<std::bad_alloc>();
+    return static_cast<T*>(p);
+  }
+
+  /// Anonymous mappings are always zero-initialized by the kernel.
+  auto allocate_zeroed(size_t n) -> T* { return allocate(n); }
+
+  void deallocate(T* p, size_t n) noexcept {
+    if (p) munmap(p, bytes(n));
+  }
+
+  /// Resizes the given mapping from 'n' to 'm' objects. The kernel moves
+  /// pages by remapping them and only zero-initialized pages are added.
+  /// On failure, 'std::bad_alloc' is thrown and the old mapping stays valid.
+  auto reallocate(T* p, size_t n, size_t m) -> T* {
+    if (!p) return allocate(m);
+    if (m > size_t(-1) / sizeof(T)) detail::raise<std::bad_array_new_length>();
+    const auto q = mremap(p, bytes(n), bytes(m), MREMAP_MAYMOVE);
+    if (q == MAP_FAILED) detail::raise<std::bad_alloc>();
+    return static_cast<T*>(q);
+  }
+
+  /// Memory is unmapped in the same way, regardless of the population.
+  template <typename U>
+  constexpr bool operator==(const mmap_allocator<U>&) const noexcept {
+    return true;
+  }
+
+  bool populate = false;
+};
+
+}  // namespace lyrahgames::robin_hood
@@ -0,0 +1,17 @@
+#pragma once
+
+namespace lyrahgames::robin_hood {
+
+/// Tag type to construct a flat container whose memory is prefaulted.
+/// @see prefaulted
+struct prefault_t {
+  explicit prefault_t() = default;
+};
+
+/// Constructors of the flat containers taking this tag as first argument
+/// reserve memory for the given count of elements and map all of its pages
+/// right away. Afterwards, the first insertions do not suffer from page
+/// faults. This is meant for services with strict latency requirements.
+inline constexpr prefault_t prefaulted{};
+
+}  // namespace lyrahgames::robin_hood
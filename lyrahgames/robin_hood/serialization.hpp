@@ -0,0 +1,217 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+//
+#include <lyrahgames/robin_hood/meta.hpp>
+//
+#include <lyrahgames/robin_hood/detail/traits.hpp>
+
+namespace lyrahgames::robin_hood {
+
+namespace detail {
+
+/// Reads the given count of trivially copyable elements into the given empty
+/// string or vector. The count stems from the stream and may be corrupted.
+/// So, memory is only allocated chunk by chunk for data that actually arrives
+/// and a failing stream stops the reading. Counts that can never be stored
+/// set the fail bit of the stream.
+template <typename Sequence>
+void read_elements(std::istream& is, Sequence& x, uint64_t n) {
+  using T                  = typename Sequence::value_type;
+  constexpr uint64_t chunk = std::max(uint64_t{1}, uint64_t{65536} / sizeof(T));
+  if (n > x.max_size()) {
+    is.setstate(std::ios_base::failbit);
+    return;
+  }
+  while (is && (x.size() < n)) {
+    const auto first = x.size();
+    const auto count = std::min(chunk, n - first);
+    x.resize(first + count);
+    is.read(reinterpret_cast<char*>(x.data() + first), count * sizeof(T));
+  }
+}
+
+}  // namespace detail
+
+/// \class serializer serialization.hpp
+/// Writes single keys and values to binary streams and reads them back for
+/// 'save' and 'load' of the flat containers. Specializations exist for
+/// trivially copyable types, strings, and vectors. Other types need their
+/// own specialization or a custom serializer with the same interface.
+template <typename T>
+struct serializer;
+
+template <typename T>
+requires std::is_trivially_copyable_v<T>
+struct serializer<T> {
+  void write(std::ostream& os, const T& x) const {
+    os.write(reinterpret_cast<const char*>(&x), sizeof(T));
+  }
+
+  auto read(std::istream& is) const -> T {
+    std::array<char, sizeof(T)> bytes{};
+    is.read(bytes.data(), sizeof(T));
+    return std::bit_cast<T>(bytes);
+  }
+};
+
+/// Strings are stored by their count of characters followed by the
+/// characters themselves.
+template <typename Char, typename Traits, typename Allocator>
+requires std::is_trivially_copyable_v<Char>
+struct serializer<std::basic_string<Char, Traits, Allocator>> {
+  using string = std::basic_string<Char, Traits, Allocator>;
+
+  void write(std::ostream& os, const string& x) const {
+    const uint64_t n = x.size();
+    os.write(reinterpret_cast<const char*>(&n), sizeof(n));
+    os.write(reinterpret_cast<const char*>(x.data()), n * sizeof(Char));
+  }
+
+  auto read(std::istream& is) const -> string {
+    uint64_t n = 0;
+    is.read(reinterpret_cast<char*>(&n), sizeof(n));
+    string x{};
+    if (is) detail::read_elements(is, x, n);
+    return x;
+  }
+};
+
+/// Vectors are stored like strings. @see serializer
+template <typename T, typename Allocator>
+requires std::is_trivially_copyable_v<T>
+struct serializer<std::vector<T, Allocator>> {
+  using vector = std::vector<T, Allocator>;
+
+  void write(std::ostream& os, const vector& x) const {
+    const uint64_t n = x.size();
+    os.write(reinterpret_cast<const char*>(&n), sizeof(n));
+    os.write(reinterpret_cast<const char*>(x.data()), n * sizeof(T));
+  }
+
+  auto read(std::istream& is) const -> vector {
+    uint64_t n = 0;
+    is.read(reinterpret_cast<char*>(&n), sizeof(n));
+    vector x{};
+    if (is) detail::read_elements(is, x, n);
+    return x;
+  }
+};
+
+namespace generic {
+
+template <typename S, typename T>
+concept serializer =
+    requires(const S& s, std::ostream& os, std::istream& is, const T& x) {
+  s.write(os, x);
+  { s.read(is) } -> std::convertible_to<T>;
+};
+
+}  // namespace generic
+
+/// Header of a stream written by 'save' of a flat container. It is followed
+/// by the PSL array of the table and the elements of all occupied slots in the
+/// order of the table. This way, 'load' puts every element directly into its
+/// old slot without rehashing or Robin Hood swapping. PSLs are stored with a
+/// single byte if all of them are small enough.
+struct serialization_header {
+  using size_type = typename detail::traits::size_type;
+  using psl_type  = typename detail::traits::psl_type;
+
+  /// The magic number reads "rhsave01" on little-endian machines.
+  static constexpr uint64_t magic_number = 0x31306576'61736872ull;
+
+  /// Returns the header of a table with the given size and element types.
+  /// A 'Value' of 'void' describes the table of a set.
+  template <typename Key, typename Value>
+  static auto make(size_type size, size_type load, psl_type max_psl) noexcept
+      -> serialization_header {
+    serialization_header h{};
+    h.magic     = magic_number;
+    h.psl_bytes = (max_psl <= UINT8_MAX) ? 1 : sizeof(psl_type);
+    h.key_bytes = sizeof(Key);
+    if constexpr (!std::is_void_v<Value>) h.value_bytes = sizeof(Value);
+    h.size = size;
+    h.load = load;
+    return h;
+  }
+
+  uint64_t magic;
+  uint64_t psl_bytes;
+  uint64_t key_bytes;
+  uint64_t value_bytes;
+  uint64_t size;
+  uint64_t load;
+  uint64_t seed;
+  uint64_t psl_bound;
+  double   max_load_ratio;
+  double   min_load_ratio;
+};
+
+namespace detail {
+
+/// Type of the values stored by a table or 'void' for the tables of sets.
+template <typename Table>
+struct table_value {
+  using type = void;
+};
+
+template <typename Table>
+requires requires { typename Table::value_type; }
+struct table_value<Table> {
+  using type = typename Table::value_type;
+};
+
+/// Writes the given PSL array with the given count of bytes per PSL.
+inline void write_psls(std::ostream&           os,
+                       const traits::psl_type* psls,
+                       traits::size_type       size,
+                       uint64_t                bytes) {
+  if (bytes == sizeof(traits::psl_type)) {
+    os.write(reinterpret_cast<const char*>(psls), size * bytes);
+    return;
+  }
+  constexpr traits::size_type chunk = 4096;
+  std::array<uint8_t, chunk>  buffer{};
+  for (traits::size_type first = 0; first < size; first += chunk) {
+    const auto count = std::min(chunk, size - first);
+    std::copy(psls + first, psls + first + count, buffer.begin());
+    os.write(reinterpret_cast<const char*>(buffer.data()), count);
+  }
+}
+
+/// Reads a PSL array written by 'write_psls' into the given empty vector.
+/// The size stems from the stream. So, as for 'read_elements', memory is only
+/// allocated chunk by chunk for PSLs that actually arrive.
+inline void read_psls(std::istream&                  is,
+                      std::vector<traits::psl_type>& psls,
+                      uint64_t                       size,
+                      uint64_t                       bytes) {
+  if (bytes == sizeof(traits::psl_type)) {
+    read_elements(is, psls, size);
+    return;
+  }
+  if (size > psls.max_size()) {
+    is.setstate(std::ios_base::failbit);
+    return;
+  }
+  constexpr uint64_t         chunk = 4096;
+  std::array<uint8_t, chunk> buffer{};
+  while (is && (psls.size() < size)) {
+    const auto count = std::min(chunk, size - psls.size());
+    is.read(reinterpret_cast<char*>(buffer.data()), count);
+    psls.insert(psls.end(), buffer.begin(), buffer.begin() + count);
+  }
+}
+
+}  // namespace detail
+
+}  // namespace lyrahgames::robin_hood
@@ -0,0 +1,525 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+//
+#include <lyrahgames/robin_hood/capacity.hpp>
+#include <lyrahgames/robin_hood/meta.hpp>
+#include <lyrahgames/robin_hood/mixer.hpp>
+#include <lyrahgames/robin_hood/shared_memory.hpp>
+//
+#include <lyrahgames/robin_hood/detail/probing.hpp>
+#include <lyrahgames/robin_hood/detail/raise.hpp>
+#include <lyrahgames/robin_hood/detail/traits.hpp>
+
+namespace lyrahgames::robin_hood {
+
+namespace detail {
+
+/// Header at the beginning of the shared memory of a 'shared_flat_map'.
+/// The PSL, key, and value arrays follow at the given offsets. So, the table
+/// does not contain any pointer and every process may map it at a different
+/// address. The sequence counter and the load are modified by the writer and
+/// read by all other processes.
+struct shared_table_header {
+  using size_type = typename traits::size_type;
+  using psl_type  = typename traits::psl_type;
+
+  /// The magic number reads "rhshrd01" on little-endian machines.
+  static constexpr uint64_t  magic_number = 0x31306472'68736872ull;
+  static constexpr size_type alignment    = 64;
+
+  static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                "Shared tables need lock-free atomics to work across "
+                "processes.");
+
+  static constexpr auto align(size_type offset) noexcept -> size_type {
+    return (offset + alignment - 1) / alignment * alignment;
+  }
+
+  /// Computes the layout of a table with the given size and element types.
+  template <typename Key, typename Value>
+  void init(size_type s, size_type m, uint64_t h) noexcept {
+    magic        = magic_number;
+    key_bytes    = sizeof(Key);
+    value_bytes  = sizeof(Value);
+    size         = s;
+    max_load     = m;
+    seed         = h;
+    psl_offset   = align(sizeof(shared_table_header));
+    key_offset   = align(psl_offset + size * sizeof(psl_type));
+    value_offset = align(key_offset + size * sizeof(Key));
+    bytes        = align(value_offset + size * sizeof(Value));
+  }
+
+  /// Returns the largest table size with the given element types whose arrays
+  /// fit into the given count of bytes. Offsets of larger sizes would be
+  /// computed with wrapping arithmetic and could falsely seem to fit.
+  template <typename Key, typename Value>
+  static constexpr auto max_size(size_type b) noexcept -> size_type {
+    constexpr auto offset = align(sizeof(shared_table_header));
+    constexpr auto slot   = sizeof(psl_type) + sizeof(Key) + sizeof(Value);
+    return (b < offset) ? 0 : (b - offset) / slot;
+  }
+
+  /// Checks that the header describes a table of the given element types
+  /// which fits into the given count of bytes.
+  template <typename Key, typename Value>
+  bool valid(size_type b) const noexcept {
+    if ((magic != magic_number) || (size > max_size<Key, Value>(b)))
+      return false;
+    shared_table_header expected{};
+    expected.init<Key, Value>(size, max_load, seed);
+    return (key_bytes == expected.key_bytes) &&
+           (value_bytes == expected.value_bytes) &&
+           (psl_offset == expected.psl_offset) &&
+           (key_offset == expected.key_offset) &&
+           (value_offset == expected.value_offset) &&
+           (bytes == expected.bytes) && (bytes <= b) && (size != 0) &&
+           (max_load < size);
+  }
+
+  uint64_t magic;
+  uint64_t key_bytes;
+  uint64_t value_bytes;
+  uint64_t size;
+  uint64_t max_load;
+  uint64_t seed;
+  uint64_t psl_offset;
+  uint64_t key_offset;
+  uint64_t value_offset;
+  uint64_t bytes;
+  // Readers poll the counter. So, it gets its own cache line.
+  alignas(alignment) std::atomic<uint64_t> sequence;
+  std::atomic<uint64_t>                    load;
+};
+
+}  // namespace detail
+
+/// \class shared_flat_map shared_flat_map.hpp
+/// Flat map whose table lives in shared memory such that multiple processes
+/// on the same host are able to use a single copy of it. One process creates
+/// the map and is the only one allowed to modify it. All other processes
+/// open the same memory read-only and query it without copying. The table
+/// is addressed by offsets relative to the beginning of the memory and may
+/// be mapped at different addresses in every process.
+/// Writes are published through a sequence counter in the shared memory in
+/// the same way as the 'seqlock' policy does for threads. Readers do their
+/// lookups optimistically and retry them if a write interfered. Hence,
+/// lookups return copies and keys and values need to be trivially copyable.
+/// If the writer process dies during a write, readers would wait forever.
+/// Instead, they throw after waiting for 'write_timeout'.
+/// The capacity is fixed when the map is created. Insertions beyond the
+/// reserved count of elements throw instead of reallocating the table.
+/// The hasher has to compute the same values in all processes. The seed of
+/// a seeded hasher is stored in the shared memory for this purpose.
+template <generic::key                       Key,
+          generic::value                     Value,
+          generic::hasher<Key>               Hasher   = std::hash<Key>,
+          generic::equivalence_relation<Key> Equality = std::equal_to<Key>,
+          typename Capacity                           = power_of_two_capacity,
+          typename Mixer                              = default_mixer<Capacity>>
+class shared_flat_map {
+ public:
+  using key_type        = Key;
+  using mapped_type     = Value;
+  using hasher          = Hasher;
+  using equality        = Equality;
+  using capacity_policy = Capacity;
+  using mixer           = Mixer;
+  using probing         = detail::probing<capacity_policy, mixer>;
+  using header          = detail::shared_table_header;
+  using size_type       = typename header::size_type;
+  using psl_type        = typename header::psl_type;
+  using real            = double;
+
+  static_assert(std::is_trivially_copyable_v<key_type> &&
+                std::is_trivially_copyable_v<mapped_type>);
+
+  static constexpr size_type min_capacity = 8;
+
+  /// Time after which readers give up waiting for a running write operation.
+  static constexpr std::chrono::milliseconds write_timeout{1000};
+
+  shared_flat_map() = default;
+
+  /// Creates a new shared-memory object with the given name containing an
+  /// empty map for the given count of elements and the given maximum load
+  /// factor. An existing object with the same name is replaced.
+  /// Throws an exception of type 'std::system_error' on failure and of type
+  /// 'std::length_error' if the table would exceed the address space.
+  static auto create(const std::string& name,
+                     size_type          count,
+                     real               max_load = 0.8,
+                     hasher             h        = {},
+                     equality           e        = {}) -> shared_flat_map {
+    return shared_flat_map{count, max_load, h, e, [&](size_t bytes) {
+                             return shared_memory::create(name, bytes);
+                           }};
+  }
+
+  /// Does the same as 'create' for a file on disk. @see create
+  static auto create_file(const std::filesystem::path& path,
+                          size_type                    count,
+                          real                         max_load = 0.8,
+                          hasher                       h        = {},
+                          equality                     e        = {})
+      -> shared_flat_map {
+    return shared_flat_map{count, max_load, h, e, [&](size_t bytes) {
+                             return shared_memory::create_file(path, bytes);
+                           }};
+  }
+
+  /// Opens the map of the shared-memory object with the given name
+  /// read-only. Throws an exception of type 'std::system_error' if it cannot
+  /// be mapped and of type 'std::invalid_argument' if it does not contain a
+  /// map of the given types and hash function.
+  static auto open(const std::string& name, hasher h = {}, equality e = {})
+      -> shared_flat_map {
+    return shared_flat_map{shared_memory::open(name), h, e};
+  }
+
+  /// Does the same as 'open' for a file on disk. @see open
+  static auto open_file(const std::filesystem::path& path,
+                        hasher                       h = {},
+                        equality                     e = {})
+      -> shared_flat_map {
+    return shared_flat_map{shared_memory::open_file(path), h, e};
+  }
+
+  /// Removes the name of the shared-memory object. @see shared_memory
+  static void unlink(const std::string& name) noexcept {
+    shared_memory::unlink(name);
+  }
+
+  /// Checks if this process is the one that is allowed to modify the map.
+  bool writable() const noexcept { return memory.is_writable(); }
+
+  /// Checks if the map contains zero elements.
+  bool empty() const noexcept { return size() == 0; }
+
+  /// Returns the count of inserted elements.
+  auto size() const noexcept -> size_type {
+    return info->load.load(std::memory_order_acquire);
+  }
+
+  /// Returns the count of elements the map has been created for.
+  auto max_size() const noexcept -> size_type { return info->max_load; }
+
+  /// Returns the size of the table.
+  auto capacity() const noexcept -> size_type { return table.size; }
+
+  auto load_factor() const noexcept { return real(size()) / capacity(); }
+
+  /// Checks if an element with the given key has been inserted.
+  /// Throws an exception of type 'std::runtime_error' if a write operation
+  /// has not been finished within 'write_timeout'.
+  bool contains(const key_type& key) const {
+    return optimistic_read(key, [](size_type, bool found) { return found; });
+  }
+
+  /// Returns a copy of the mapped value of the given key or an empty optional
+  /// if no such element exists.
+  auto lookup(const key_type& key) const -> std::optional<mapped_type> {
+    return optimistic_read(
+        key, [this](size_type index, bool found) -> std::optional<mapped_type> {
+          if (!found) return std::nullopt;
+          return table.values[index];
+        });
+  }
+
+  /// Returns a copy of the mapped value of the given key. If no such element
+  /// exists, an exception of type 'std::invalid_argument' is thrown.
+  auto operator()(const key_type& key) const -> mapped_type {
+    if (auto value = lookup(key)) return *value;
+    detail::raise<std::invalid_argument>("Failed to find the given key.");
+  }
+
+  /// Inserts the given element. Throws an exception of type
+  /// 'std::invalid_argument' if the key has already been inserted and of type
+  /// 'std::overflow_error' if the map is full.
+  void insert(const key_type& key, const mapped_type& value) {
+    if (!try_insert(key, value))
+      detail::raise<std::invalid_argument>(
+          "Failed to insert element that already exists!");
+  }
+
+  /// Inserts the given element if its key has not been inserted yet and
+  /// returns if this happened. Throws 'std::overflow_error' if the map is full.
+  bool try_insert(const key_type& key, const mapped_type& value) {
+    check_writable();
+    const auto [index, psl, found] = lookup_data(key);
+    if (found) return false;
+    basic_insert(index, psl, key, value);
+    return true;
+  }
+
+  /// Assigns the given value to the element with the given key. If there is
+  /// no such element, an exception of type 'std::invalid_argument' is thrown.
+  void assign(const key_type& key, const mapped_type& value) {
+    check_writable();
+    const auto [index, psl, found] = lookup_data(key);
+    if (!found)
+      detail::raise<std::invalid_argument>(
+          "Failed to find the given key.");
+    const auto section  = write_section();
+    table.values[index] = value;
+  }
+
+  /// Inserts an element if it not already exists.
+  /// Otherwise, assigns a new value to it.
+  void insert_or_assign(const key_type& key, const mapped_type& value) {
+    check_writable();
+    const auto [index, psl, found] = lookup_data(key);
+    if (!found) {
+      basic_insert(index, psl, key, value);
+      return;
+    }
+    const auto section  = write_section();
+    table.values[index] = value;
+  }
+
+  /// Removes the element with the given key. If there is no such element,
+  /// an exception of type 'std::invalid_argument' is thrown.
+  void remove(const key_type& key) {
+    if (!try_remove(key))
+      detail::raise<std::invalid_argument>(
+          "Failed to remove non-existing key!");
+  }
+
+  /// Removes the element with the given key and returns if it existed.
+  bool try_remove(const key_type& key) {
+    check_writable();
+    const auto [index, psl, found] = lookup_data(key);
+    if (!found) return false;
+    basic_remove(index);
+    return true;
+  }
+
+  /// Removes all elements.
+  void clear() {
+    check_writable();
+    const auto section = write_section();
+    std::fill(table.psls, table.psls + table.size, 0);
+    info->load.store(0, std::memory_order_relaxed);
+  }
+
+ private:
+  /// Pointers to the arrays of the table inside the mapping of this process.
+  struct table_type {
+    auto psl(size_type index) const noexcept { return psls[index]; }
+
+    auto key(size_type index) const noexcept -> const key_type& {
+      return keys[index];
+    }
+
+    size_type    size   = 0;
+    psl_type*    psls   = nullptr;
+    key_type*    keys   = nullptr;
+    mapped_type* values = nullptr;
+  };
+
+  /// Increments the shared sequence counter before and after a modification.
+  /// Only the writer process is allowed to use it.
+  class write_section_type {
+   public:
+    explicit write_section_type(header& h) noexcept : info{h} {
+      info.sequence.store(info.sequence.load(std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    ~write_section_type() noexcept {
+      info.sequence.store(info.sequence.load(std::memory_order_relaxed) + 1,
+                          std::memory_order_release);
+    }
+
+    write_section_type(const write_section_type&) = delete;
+    write_section_type& operator=(const write_section_type&) = delete;
+
+   private:
+    header& info;
+  };
+
+  /// Creates the memory by the given function and initializes an empty table.
+  template <typename F>
+  shared_flat_map(size_type count, real m, hasher h, equality e, F&& make)
+      : hash{h}, equal{e} {
+    // Rounding by the capacity policy may double the size.
+    constexpr auto max_size =
+        header::max_size<key_type, mapped_type>(size_type(-1)) / 2;
+    if (count / m >= max_size)
+      detail::raise<std::length_error>(
+          "Failed to create shared map for the given count of elements!");
+    const auto size = capacity_policy::round(
+        std::max(min_capacity, size_type(count / m) + 1));
+    uint64_t seed = 0;
+    if constexpr (generic::readable_seeded_hasher<hasher>) seed = hash.seed;
+    header layout{};
+    layout.template init<key_type, mapped_type>(
+        size, std::min(size - 1, std::max(count, size_type(m * size))), seed);
+    memory = std::forward<F>(make)(layout.bytes);
+    info   = new (memory.data()) header{};
+    info->template init<key_type, mapped_type>(layout.size, layout.max_load,
+                                               seed);
+    info->sequence.store(0, std::memory_order_relaxed);
+    info->load.store(0, std::memory_order_release);
+    map_table();
+  }
+
+  /// Validates the table inside the given memory and maps it.
+  shared_flat_map(shared_memory&& m, hasher h, equality e)
+      : memory{std::move(m)}, hash{h}, equal{e} {
+    if ((memory.size() < sizeof(header)) ||
+        !reinterpret_cast<const header*>(memory.data())
+             ->template valid<key_type, mapped_type>(memory.size()))
+      detail::raise<std::invalid_argument>(
+          "Failed to open shared memory without a map of the given types!");
+    info = reinterpret_cast<header*>(memory.data());
+    if (capacity_policy::round(info->size) != info->size)
+      detail::raise<std::invalid_argument>(
+          "Failed to open map whose size violates the capacity policy!");
+    if constexpr (generic::readable_seeded_hasher<hasher>)
+      hash.reseed(info->seed);
+    map_table();
+    if (!optimistic_placed())
+      detail::raise<std::invalid_argument>(
+          "Failed to open map written with a different hash function!");
+  }
+
+  void map_table() noexcept {
+    const auto base = memory.data();
+    table.size      = info->size;
+    table.psls      = reinterpret_cast<psl_type*>(base + info->psl_offset);
+    table.keys      = reinterpret_cast<key_type*>(base + info->key_offset);
+    table.values = reinterpret_cast<mapped_type*>(base + info->value_offset);
+  }
+
+  void check_writable() const {
+    if (!writable())
+      detail::raise<std::invalid_argument>(
+          "Failed to modify read-only shared map!");
+  }
+
+  auto write_section() noexcept { return write_section_type{*info}; }
+
+  /// Waits until no write operation is running and returns the current state
+  /// of the sequence counter. The writer process has most likely died during
+  /// a write if this takes longer than 'write_timeout'. In this case, an
+  /// exception of type 'std::runtime_error' is thrown.
+  auto read_begin() const -> uint64_t {
+    constexpr size_type spins_per_check = 1024;
+
+    auto s = info->sequence.load(std::memory_order_acquire);
+    if (!(s & 1)) return s;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_type spins = 1;; ++spins) {
+      s = info->sequence.load(std::memory_order_acquire);
+      if (!(s & 1)) return s;
+      if (spins % spins_per_check) continue;
+      if (std::chrono::steady_clock::now() - start > write_timeout)
+        detail::raise<std::runtime_error>(
+            "Failed to read shared map whose write has not been finished!");
+      std::this_thread::yield();
+    }
+  }
+
+  /// Checks if no write operation has been started since the given state.
+  bool read_validate(uint64_t s) const noexcept {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return s == info->sequence.load(std::memory_order_relaxed);
+  }
+
+  /// Looks up the given key and calls the given function with the index and
+  /// a boolean indicating if the key has been found until no write interfered.
+  template <typename F>
+  auto optimistic_read(const key_type& key, F&& f) const {
+    while (true) {
+      const auto s                   = read_begin();
+      const auto [index, psl, found] = lookup_data(key);
+      auto result                    = f(index, found);
+      if (read_validate(s)) return result;
+    }
+  }
+
+  auto next(size_type index) const noexcept -> size_type {
+    return probing::next(index, table.size);
+  }
+
+  /// Does the same as 'hash_base::lookup_data' on the shared table.
+  auto lookup_data(const key_type& key) const noexcept
+      -> std::tuple<size_type, psl_type, bool> {
+    return probing::lookup_data(table, key, hash(key), equal);
+  }
+
+  /// Recomputes the positions of the first occupied slots to detect a
+  /// different hasher, mixer, or capacity policy. @see probing::placed
+  bool optimistic_placed() const {
+    while (true) {
+      const auto s      = read_begin();
+      const auto result = probing::placed(table, hash);
+      if (read_validate(s)) return result;
+    }
+  }
+
+  /// Inserts the element at the index and PSL computed by 'lookup_data' by
+  /// Robin Hood swapping.
+  void basic_insert(size_type          index,
+                    psl_type           psl,
+                    const key_type&    key,
+                    const mapped_type& value) {
+    if (size() >= info->max_load)
+      detail::raise<std::overflow_error>(
+          "Failed to insert element into full map!");
+    const auto section = write_section();
+    auto       k       = key;
+    auto       v       = value;
+    for (; table.psls[index]; ++psl) {
+      if (psl > table.psls[index]) {
+        std::swap(k, table.keys[index]);
+        std::swap(v, table.values[index]);
+        std::swap(psl, table.psls[index]);
+      }
+      index = next(index);
+    }
+    table.keys[index]   = k;
+    table.values[index] = v;
+    table.psls[index]   = psl;
+    info->load.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// Erases the element at the given index and moves the subsequent elements
+  /// one step back. @see hash_base::basic_remove
+  void basic_remove(size_type index) {
+    const auto section    = write_section();
+    auto       next_index = next(index);
+    while (table.psls[next_index] > 1) {
+      table.keys[index]   = table.keys[next_index];
+      table.values[index] = table.values[next_index];
+      table.psls[index]   = table.psls[next_index] - 1;
+
+      index      = next_index;
+      next_index = next(next_index);
+    }
+    table.psls[index] = 0;
+    info->load.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  shared_memory memory{};
+  header*       info = nullptr;
+  table_type    table{};
+  hasher        hash{};
+  equality      equal{};
+};
+
+}  // namespace lyrahgames::robin_hood
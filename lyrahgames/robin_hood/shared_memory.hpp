@@ -0,0 +1,106 @@
+#pragma once
+#include <cerrno>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <utility>
+//
+#if !defined(__linux__)
+#error "Shared memory is only available on Linux."
+#endif
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+//
+#include <lyrahgames/robin_hood/detail/memory_mapping.hpp>
+
+namespace lyrahgames::robin_hood {
+
+/// \class shared_memory shared_memory.hpp
+/// Mapping of a POSIX shared-memory object or of a file which is shared with
+/// all other processes mapping the same object. Objects are identified by
+/// names of the form "/name" and live in memory until they are unlinked.
+/// Files additionally persist on disk. Creating processes map the memory with
+/// write access. All other processes may map it read-only.
+class shared_memory {
+ public:
+  shared_memory() = default;
+
+  /// Creates a new shared-memory object with the given name and count of
+  /// zero-initialized bytes and maps it writable. An existing object with the
+  /// same name is replaced. Throws 'std::system_error' on failure.
+  static auto create(const std::string& name, size_t bytes) -> shared_memory {
+    ::shm_unlink(name.c_str());
+    const auto fd =
+        ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0644);
+    if (fd < 0) fail("Failed to create shared-memory object!");
+    return shared_memory{mapping{fd, bytes, true}, true};
+  }
+
+  /// Maps the existing shared-memory object with the given name.
+  /// Throws 'std::system_error' on failure.
+  static auto open(const std::string& name, bool writable = false)
+      -> shared_memory {
+    const auto fd =
+        ::shm_open(name.c_str(), (writable ? O_RDWR : O_RDONLY) | O_CLOEXEC, 0);
+    if (fd < 0) fail("Failed to open shared-memory object!");
+    return shared_memory{mapping{fd, writable}, writable};
+  }
+
+  /// Removes the name of the shared-memory object. Its memory is freed when
+  /// the last process has unmapped it.
+  static void unlink(const std::string& name) noexcept {
+    ::shm_unlink(name.c_str());
+  }
+
+  /// Does the same as 'create' for a file on disk.
+  static auto create_file(const std::filesystem::path& path, size_t bytes)
+      -> shared_memory {
+    const auto fd =
+        ::open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR | O_CLOEXEC, 0644);
+    if (fd < 0) fail("Failed to create shared file!");
+    return shared_memory{mapping{fd, bytes, true}, true};
+  }
+
+  /// Does the same as 'open' for a file on disk.
+  static auto open_file(const std::filesystem::path& path,
+                        bool                         writable = false)
+      -> shared_memory {
+    const auto fd =
+        ::open(path.c_str(), (writable ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+    if (fd < 0) fail("Failed to open shared file!");
+    return shared_memory{mapping{fd, writable}, writable};
+  }
+
+  shared_memory(shared_memory&& m) noexcept
+      : memory{std::move(m.memory)},
+        writable{std::exchange(m.writable, false)} {}
+
+  shared_memory& operator=(shared_memory&& m) noexcept {
+    std::swap(memory, m.memory);
+    std::swap(writable, m.writable);
+    return *this;
+  }
+
+  auto data() noexcept { return memory.data(); }
+
+  auto data() const noexcept { return memory.data(); }
+
+  auto size() const noexcept { return memory.size(); }
+
+  bool is_writable() const noexcept { return writable; }
+
+ private:
+  using mapping = detail::memory_mapping;
+
+  shared_memory(mapping&& m, bool w) noexcept
+      : memory{std::move(m)}, writable{w} {}
+
+  [[noreturn]] static void fail(const char* message) { mapping::fail(message); }
+
+  mapping memory{};
+  bool    writable = false;
+};
+
+}  // namespace lyrahgames::robin_hood
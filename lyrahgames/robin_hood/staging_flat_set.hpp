@@ -0,0 +1,147 @@
+#pragma once
+#include <cassert>
+#include <mutex>
+//
+#include <lyrahgames/robin_hood/meta.hpp>
+//
+#include <lyrahgames/robin_hood/flat_set.hpp>
+//
+#include <lyrahgames/robin_hood/detail/raise.hpp>
+
+namespace lyrahgames::robin_hood {
+
+/// \class staging_flat_set staging_flat_set.hpp
+/// A flat set which is filled concurrently by multiple producer threads.
+/// Every thread inserts its keys into a private staging set obtained by
+/// 'stage'. Staging sets are merged in bulk into the shared set as soon as
+/// they contain a given count of keys. This way, the synchronization of the
+/// shared set is amortized over thousands of keys.
+/// To keep the lock short, merges are postponed when the shared set is busy
+/// and only forced when a staging set has grown four times beyond its
+/// merge threshold.
+template <generic::key                       Key,
+          generic::hasher<Key>               Hasher    = std::hash<Key>,
+          generic::equivalence_relation<Key> Equality  = std::equal_to<Key>,
+          generic::allocator                 Allocator = std::allocator<Key>>
+class staging_flat_set {
+ public:
+  using container = flat_set<Key, Hasher, Equality, Allocator>;
+  using key_type  = Key;
+  using allocator = Allocator;
+  using hasher    = Hasher;
+  using equality  = Equality;
+  using size_type = typename container::size_type;
+
+  /// Private staging set of a single producer thread.
+  /// It is not thread-safe itself and has to be destroyed
+  /// before the shared set it has been created by.
+  class stage_type {
+   public:
+    explicit stage_type(staging_flat_set& s)
+        : shared{&s},
+          local(s.threshold, s.hash, s.equal, s.alloc),
+          threshold{s.threshold} {}
+
+    /// The remaining keys are merged into the shared set. If this fails, e.g.
+    /// because memory cannot be allocated, the remaining keys are lost and
+    /// debug builds stop at an assertion. Call 'flush' explicitly before to be
+    /// able to handle such failures.
+    ~stage_type() noexcept {
+      LYRAHGAMES_ROBIN_HOOD_TRY { flush(); }
+      LYRAHGAMES_ROBIN_HOOD_CATCH {
+        assert(local.empty() && "Failed to flush stage on destruction!");
+      }
+    }
+
+    stage_type(stage_type&& s) noexcept
+        : shared{s.shared}, local{std::move(s.local)}, threshold{s.threshold} {
+      s.shared = nullptr;
+    }
+
+    stage_type& operator=(stage_type&&) = delete;
+    stage_type(const stage_type&)       = delete;
+    stage_type& operator=(const stage_type&) = delete;
+
+    /// Returns the count of keys which have not been merged yet.
+    auto size() const noexcept { return local.size(); }
+
+    /// Inserts the given key into the staging set.
+    /// If the key has already been staged, nothing is done.
+    template <generic::forwardable<key_type> K>
+    void insert(K&& key) {
+      local.try_insert(std::forward<K>(key));
+      if (local.size() < threshold) return;
+      if (local.size() < 4 * threshold) {
+        std::unique_lock lock{shared->mutex, std::try_to_lock};
+        if (lock) merge();
+        return;
+      }
+      flush();
+    }
+
+    /// Blocks until all staged keys have been merged into the shared set.
+    void flush() {
+      if (!shared || local.empty()) return;
+      std::scoped_lock lock{shared->mutex};
+      merge();
+    }
+
+   private:
+    /// Merges all staged keys into the shared set.
+    /// Assumes the mutex of the shared set has been locked.
+    void merge() {
+      auto& set = shared->set;
+      set.reserve(set.size() + local.size());
+      for (const auto& k : local)
+        set.nocheck_static_insert(k);
+      local.clear();
+    }
+
+    staging_flat_set* shared;
+    container         local;
+    size_type         threshold;
+  };
+
+  explicit staging_flat_set(size_type t = 4096,
+                            hasher    h = {},
+                            equality  e = {},
+                            allocator a = {})
+      : set(t, h, e, a), hash{h}, equal{e}, alloc{a}, threshold{t} {}
+
+  /// Returns a new staging set for the calling thread.
+  auto stage() { return stage_type{*this}; }
+
+  /// Returns the count of merged keys.
+  auto size() const {
+    std::scoped_lock lock{mutex};
+    return set.size();
+  }
+
+  /// Checks if the given key has already been merged into the shared set.
+  bool contains(const key_type& key) const {
+    std::scoped_lock lock{mutex};
+    return set.contains(key);
+  }
+
+  /// Returns the count of keys at which a staging set is merged.
+  auto merge_threshold() const noexcept { return threshold; }
+
+  /// Moves the shared set out of the staging set.
+  /// All stages have to be flushed or destroyed before.
+  auto release() -> container {
+    std::scoped_lock lock{mutex};
+    container result(0, hash, equal, alloc);
+    std::swap(result, set);
+    return result;
+  }
+
+ private:
+  container          set;
+  hasher             hash{};
+  equality           equal{};
+  allocator          alloc{};
+  size_type          threshold;
+  mutable std::mutex mutex{};
+};
+
+}  // namespace lyrahgames::robin_hood
@@ -0,0 +1,111 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace lyrahgames::robin_hood {
+
+/// Default synchronization policy of the flat containers.
+/// No synchronization is done at all and every member is a no-op.
+struct unsynchronized {
+  struct write_section {
+    // A user-provided destructor marks the section as a scope guard such that
+    // compilers do not warn about it being unused.
+    constexpr ~write_section() noexcept {}
+  };
+
+  /// Marks the beginning of a write operation until the returned object dies.
+  constexpr auto write() noexcept { return write_section{}; }
+
+  /// Returns the state against which an optimistic read is validated.
+  constexpr auto read_begin() const noexcept { return size_t{0}; }
+
+  /// Checks if an optimistic read started with the given state is valid.
+  constexpr bool read_validate(size_t) const noexcept { return true; }
+
+  /// Takes the old table after a reallocation.
+  /// Here, it is destroyed immediately.
+  template <typename T>
+  constexpr void retire(T&&) noexcept {}
+};
+
+/// Synchronization policy for a single writer and multiple readers.
+/// The writer increments a sequence counter before and after each
+/// modification of the table. Readers do their lookups optimistically and
+/// retry them whenever the sequence counter has changed in the meantime.
+/// Hence, readers never write to shared cache lines.
+/// Old tables are retired after a reallocation instead of being freed such
+/// that readers are never able to access deallocated memory. The writer may
+/// free them by calling 'reclaim' when no reader is active.
+/// Optimistic reads are only allowed for trivially copyable keys and values.
+/// Modifications through references and iterators are not protected.
+class seqlock {
+ public:
+  class write_section {
+   public:
+    explicit write_section(seqlock& l) noexcept : lock{l} {
+      if (lock.depth++) return;
+      lock.sequence.store(lock.sequence.load(std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    ~write_section() noexcept {
+      if (--lock.depth) return;
+      lock.sequence.store(lock.sequence.load(std::memory_order_relaxed) + 1,
+                          std::memory_order_release);
+    }
+
+    write_section(const write_section&) = delete;
+    write_section& operator=(const write_section&) = delete;
+
+   private:
+    seqlock& lock;
+  };
+
+  seqlock() = default;
+
+  // Every table has its own sequence counter and retired tables.
+  seqlock(const seqlock&) noexcept : seqlock{} {}
+  seqlock& operator=(const seqlock&) noexcept { return *this; }
+  seqlock(seqlock&& l) noexcept : retired{std::move(l.retired)} {}
+  seqlock& operator=(seqlock&& l) noexcept {
+    std::swap(retired, l.retired);
+    return *this;
+  }
+
+  /// Marks the beginning of a write operation until the returned object dies.
+  /// Write sections may be nested. Only the outermost one changes the counter.
+  auto write() noexcept { return write_section{*this}; }
+
+  /// Waits until no write operation is running and returns the current state
+  /// of the sequence counter.
+  auto read_begin() const noexcept {
+    auto s = sequence.load(std::memory_order_acquire);
+    while (s & 1) s = sequence.load(std::memory_order_acquire);
+    return s;
+  }
+
+  /// Checks if no write operation has been started since the given state.
+  bool read_validate(size_t s) const noexcept {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return s == sequence.load(std::memory_order_relaxed);
+  }
+
+  /// Keeps the old table alive after a reallocation.
+  template <typename T>
+  void retire(T&& t) {
+    retired.push_back(std::make_shared<std::decay_t<T>>(std::forward<T>(t)));
+  }
+
+  /// Frees all retired tables. Only call this when no reader is active.
+  void reclaim() noexcept { retired.clear(); }
+
+ private:
+  std::atomic<size_t>                sequence{0};
+  size_t                             depth = 0;
+  std::vector<std::shared_ptr<void>> retired{};
+};
+
+}  // namespace lyrahgames::robin_hood
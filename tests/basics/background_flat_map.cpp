@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+//
+#include <doctest/doctest.h>
+//
+#include <lyrahgames/robin_hood/background_flat_map.hpp>
+
+using namespace std;
+using namespace lyrahgames;
+
+namespace {
+
+// Allocations of more objects than the limit fail for all element types.
+size_t allocation_limit = SIZE_MAX;
+
+template <typename T>
+struct limited_allocator {
+  using value_type = T;
+
+  limited_allocator() noexcept = default;
+
+  template <typename U>
+  constexpr limited_allocator(const limited_allocator<U>&) noexcept {}
+
+  auto allocate(size_t n) -> T* {
+    if (n > allocation_limit) throw bad_alloc{};
+    return allocator<T>{}.allocate(n);
+  }
+
+  void deallocate(T* p, size_t n) noexcept { allocator<T>{}.deallocate(p, n); }
+
+  template <typename U>
+  constexpr bool operator==(const limited_allocator<U>&) const noexcept {
+    return true;
+  }
+};
+
+}  // namespace
+
+SCENARIO("robin_hood::background_flat_map: Rehashing in the Background") {
+  GIVEN("an empty map with a small soft load factor") {
+    robin_hood::background_flat_map<int, string> map(8, 0.5, 0.8);
+
+    CHECK(map.empty());
+    CHECK(map.soft_load_factor() == 0.5);
+
+    WHEN("inserting, assigning, and removing many elements") {
+      mt19937                       rng{random_device{}()};
+      uniform_int_distribution<int> dist{0, 5000};
+      unordered_map<int, string>    reference{};
+      size_t                        started_rehashes = 0;
+
+      for (size_t i = 0; i < 20000; ++i) {
+        const auto key = dist(rng);
+        switch (i % 4) {
+          case 0:
+            map.insert_or_assign(key, to_string(i));
+            reference[key] = to_string(i);
+            break;
+          case 1:
+            map.try_insert(key, to_string(key));
+            reference.try_emplace(key, to_string(key));
+            break;
+          case 2:
+            map.try_remove(key);
+            reference.erase(key);
+            break;
+          case 3:
+            map[key] += "x";
+            reference[key] += "x";
+            break;
+        }
+        started_rehashes += map.rehashing();
+        REQUIRE(map.size() == reference.size());
+      }
+
+      THEN(
+          "every element is found with its latest value, before and after "
+          "the background rehash has been finished.") {
+        CHECK(started_rehashes > 0);
+        for (const auto& [k, v] : reference) {
+          CHECK(map.contains(k));
+          CHECK(map(k) == v);
+        }
+
+        map.synchronize();
+        CHECK(!map.rehashing());
+        CHECK(map.size() == reference.size());
+        CHECK(map.load_factor() < map.max_load_factor());
+
+        size_t count = 0;
+        for (const auto& [k, v] : map) {
+          CHECK(reference.at(k) == v);
+          ++count;
+        }
+        CHECK(count == reference.size());
+      }
+    }
+
+    WHEN("inserting an already existing key") {
+      for (int i = 0; i < 100; ++i)
+        map.insert(i, to_string(i));
+
+      THEN("an exception is thrown regardless of a running rehash.") {
+        for (int i = 0; i < 100; ++i)
+          CHECK_THROWS_AS(map.insert(i, ""), invalid_argument);
+        CHECK(map.size() == 100);
+        CHECK_THROWS_AS(map.remove(100), invalid_argument);
+        CHECK_THROWS_AS(map(100), invalid_argument);
+      }
+    }
+  }
+  GIVEN("a map whose background rehash is unable to allocate a new table") {
+    robin_hood::background_flat_map<int, int, hash<int>, equal_to<int>,
+                                    limited_allocator<int>>
+        map(64, 0.5, 0.8);
+    allocation_limit = map.capacity();
+    unordered_map<int, int> reference{};
+    for (int i = 0; !map.rehashing(); ++i) {
+      map.insert(i, i);
+      reference[i] = i;
+    }
+
+    WHEN("writing elements while the background worker fails") {
+      // Writes which notice the failure throw and are not applied.
+      size_t     failures = 0;
+      const auto write    = [&](auto&& f) {
+        try {
+          f();
+          return true;
+        } catch (const bad_alloc&) {
+          ++failures;
+          return false;
+        }
+      };
+      for (int i = 0; i < 20; ++i) {
+        if (write([&] { map.insert_or_assign(1000 + i, i); }))
+          reference[1000 + i] = i;
+        if (write([&] { map.try_remove(i); })) reference.erase(i);
+      }
+      if (map.rehashing()) {
+        CHECK_THROWS_AS(map.synchronize(), bad_alloc);
+        ++failures;
+      }
+
+      THEN("no successful write is lost and the map keeps working.") {
+        CHECK(failures > 0);
+        CHECK(!map.rehashing());
+        CHECK(map.size() == reference.size());
+        for (const auto& [k, v] : reference)
+          CHECK(map(k) == v);
+
+        allocation_limit = SIZE_MAX;
+        for (int i = 2000; i < 2100; ++i) {
+          map.insert(i, i);
+          reference[i] = i;
+        }
+        map.synchronize();
+        CHECK(map.size() == reference.size());
+        for (const auto& [k, v] : reference)
+          CHECK(map(k) == v);
+      }
+    }
+    allocation_limit = SIZE_MAX;
+  }
+}
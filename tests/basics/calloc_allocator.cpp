@@ -0,0 +1,57 @@
+#include <cstdint>
+#include <string>
+//
+#include <doctest/doctest.h>
+//
+#include <lyrahgames/robin_hood/calloc_allocator.hpp>
+#include <lyrahgames/robin_hood/flat_map.hpp>
+#include <lyrahgames/robin_hood/flat_set.hpp>
+#include <lyrahgames/robin_hood/mmap_allocator.hpp>
+
+using namespace std;
+using namespace lyrahgames;
+
+SCENARIO("robin_hood::calloc_allocator: Lazily Zeroed PSL Arrays") {
+  using allocator = robin_hood::calloc_allocator<string>;
+  using map_type  = robin_hood::flat_map<string, uint64_t, hash<string>,
+                                        equal_to<string>, allocator>;
+  static_assert(map_type::base::container::zeroed_psls);
+  static_assert(!robin_hood::flat_map<int, int>::base::container::zeroed_psls);
+  static_assert(robin_hood::flat_set<int, hash<int>, equal_to<int>,
+                                     robin_hood::mmap_allocator<int>>::base::
+                    container::zeroed_psls);
+
+  GIVEN("a map with the calloc allocator and a huge reservation") {
+    map_type map(8, allocator{});
+    map.reserve(1 << 20);
+
+    THEN("all slots start out empty.") {
+      CHECK(map.empty());
+      CHECK(map.begin() == map.end());
+    }
+
+    WHEN("inserting elements and triggering reallocations") {
+      for (uint64_t i = 0; i < 3000000; i += 3)
+        map.insert(to_string(i), i);
+
+      THEN("all elements can be found with their values.") {
+        CHECK(map.size() == 1000000);
+        for (uint64_t i = 0; i < 3000000; i += 3)
+          REQUIRE(map(to_string(i)) == i);
+        CHECK(!map.contains("1"));
+      }
+    }
+
+    WHEN("copying and clearing the map") {
+      map.insert("key", 1);
+      auto copy = map;
+      map.clear();
+
+      THEN("the copy keeps its elements.") {
+        CHECK(map.empty());
+        CHECK(copy.size() == 1);
+        CHECK(copy("key") == 1);
+      }
+    }
+  }
+}
@@ -0,0 +1,119 @@
+#include <cstdint>
+#include <random>
+#include <ratio>
+#include <type_traits>
+#include <unordered_set>
+//
+#include <doctest/doctest.h>
+//
+#include <lyrahgames/robin_hood/capacity.hpp>
+#include <lyrahgames/robin_hood/flat_map.hpp>
+#include <lyrahgames/robin_hood/flat_set.hpp>
+#include <lyrahgames/robin_hood/mmap_allocator.hpp>
+
+using namespace std;
+using namespace lyrahgames;
+
+namespace {
+
+// Range reduction by multiplication needs well-distributed high bits.
+struct mixing_hash {
+  size_t operator()(uint64_t x) const noexcept {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    return x;
+  }
+};
+
+}  // namespace
+
+SCENARIO("robin_hood::arbitrary_capacity: Non-Power-of-Two Table Sizes") {
+  using capacity_policy = robin_hood::arbitrary_capacity<>;
+  using set_type =
+      robin_hood::flat_set<uint64_t, mixing_hash, equal_to<uint64_t>,
+                           allocator<uint64_t>, robin_hood::unsynchronized,
+                           capacity_policy>;
+
+  static_assert(capacity_policy::multiply_high(~size_t{0}, 10) == 9);
+  static_assert(capacity_policy::multiply_high(size_t{1} << 63, 6) == 3);
+  static_assert(capacity_policy::grow(8) == 12);
+  static_assert(robin_hood::arbitrary_capacity<ratio<5, 4>>::grow(8) == 10);
+  static_assert(robin_hood::power_of_two_capacity::round(1000) == 1024);
+
+  GIVEN("a set with the arbitrary capacity policy") {
+    set_type set{};
+
+    WHEN("reserving memory for a given count of elements") {
+      set.reserve(1000);
+
+      THEN("the capacity is not rounded up to the next power of two.") {
+        CHECK(set.capacity() == 1250);
+      }
+    }
+
+    WHEN("inserting and removing random elements") {
+      mt19937                 rng{random_device{}()};
+      unordered_set<uint64_t> reference{};
+      auto                    capacity = set.capacity();
+      for (size_t i = 0; i < 50000; ++i) {
+        const uint64_t key = rng() % 100000;
+        if (rng() % 4) {
+          set.try_insert(key);
+          reference.insert(key);
+        } else {
+          set.try_remove(key);
+          reference.erase(key);
+        }
+        // The table grows by the given factor.
+        if (set.capacity() != capacity) {
+          CHECK(set.capacity() == capacity * 3 / 2);
+          capacity = set.capacity();
+        }
+      }
+
+      THEN("the set contains exactly the same elements.") {
+        CHECK(set.size() == reference.size());
+        CHECK(set.load_factor() <= set.max_load_factor());
+        for (uint64_t k = 0; k < 100000; ++k)
+          REQUIRE(set.contains(k) == reference.contains(k));
+      }
+    }
+  }
+
+  GIVEN("a map of integers with the identity hash of the standard library") {
+    robin_hood::flat_map<int, int, hash<int>, equal_to<int>, allocator<int>,
+                         robin_hood::unsynchronized, capacity_policy>
+        map{};
+    static_assert(
+        is_same_v<decltype(map)::mixer, robin_hood::fibonacci_mixer>);
+
+    WHEN("inserting consecutive small keys") {
+      for (int i = 0; i < 20000; ++i)
+        map.insert(i, i);
+
+      THEN("the default mixer keeps probe sequences short.") {
+        CHECK(map.size() == 20000);
+        CHECK(map.max_psl() < 32);
+      }
+    }
+  }
+
+  GIVEN("a map of trivially copyable elements with the mmap allocator") {
+    robin_hood::flat_map<uint64_t, uint64_t, mixing_hash, equal_to<uint64_t>,
+                         robin_hood::mmap_allocator<uint64_t>,
+                         robin_hood::unsynchronized, capacity_policy>
+        map{};
+
+    WHEN("growing it in place") {
+      for (uint64_t i = 0; i < 20000; ++i)
+        map.insert(i, 2 * i);
+
+      THEN("all elements are found with their values.") {
+        CHECK(map.size() == 20000);
+        for (uint64_t i = 0; i < 20000; ++i)
+          REQUIRE(map(i) == 2 * i);
+      }
+    }
+  }
+}
@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+//
+#include <doctest/doctest.h>
+//
+#include <lyrahgames/robin_hood/flat_map.hpp>
+#include <lyrahgames/robin_hood/flat_set.hpp>
+#include <lyrahgames/robin_hood/hash.hpp>
+
+using namespace std;
+using namespace lyrahgames;
+
+namespace {
+
+using map_type = robin_hood::flat_map<uint64_t, uint64_t,
+                                      robin_hood::hash<uint64_t>>;
+using set_type = robin_hood::flat_set<string, robin_hood::hash<string>>;
+
+// Computes the length of the Collatz sequence of every number below the given
+// count by memoizing the lengths of all visited numbers in a map.
+template <size_t n>
+constexpr auto collatz_lengths() {
+  map_type lengths{};
+  lengths.insert(1, 1);
+  for (uint64_t i = 2; i < n; ++i) {
+    uint64_t x     = i;
+    uint64_t steps = 0;
+    while (!lengths.contains(x)) {
+      x = (x % 2) ? (3 * x + 1) : (x / 2);
+      ++steps;
+    }
+    lengths.insert(i, lengths(x) + steps);
+  }
+  array<uint64_t, n> result{};
+  for (uint64_t i = 1; i < n; ++i)
+    result[i] = lengths(i);
+  return result;
+}
+
+constexpr auto distinct_words() {
+  const array words{"robin", "hood", "hashing", "robin", "hood", "table"};
+  set_type    set{};
+  for (const auto& word : words)
+    set.try_insert(string{word});
+  auto copy = set;
+  copy.remove(string{"table"});
+  return pair{set.size(), copy.size()};
+}
+
+constexpr auto removals() {
+  map_type map{};
+  for (uint64_t i = 0; i < 1000; ++i)
+    map.insert(i, i);
+  for (uint64_t i = 0; i < 1000; i += 2)
+    map.remove(i);
+  map.shrink_to_fit();
+  uint64_t sum = 0;
+  for (const auto& [key, value] : map)
+    sum += value;
+  return pair{map.size(), sum};
+}
+
+// Tables are built during compilation and only the results are stored.
+constexpr auto lengths = collatz_lengths<100>();
+static_assert(lengths[1] == 1);
+static_assert(lengths[6] == 9);
+static_assert(lengths[27] == 112);
+static_assert(distinct_words() == pair{size_t{4}, size_t{3}});
+static_assert(removals() == pair{size_t{500}, uint64_t{250000}});
+
+}  // namespace
+
+SCENARIO("robin_hood::flat_map: Constant Evaluation") {
+  GIVEN("a table of values precomputed by a map in a constant expression") {
+    THEN("a map filled at runtime yields the same values.") {
+      map_type map{};
+      for (uint64_t i = 1; i < lengths.size(); ++i)
+        map.insert(i, lengths[i]);
+      const auto runtime = collatz_lengths<100>();
+      CHECK(std::ranges::equal(runtime, lengths));
+      CHECK(map(27) == 112);
+    }
+  }
+}
@@ -1,6 +1,7 @@
 #include <atomic>
 #include <iomanip>
 #include <iostream>
+#include <memory_resource>
 #include <random>
 #include <span>
 #include <string>
@@ -8,6 +9,7 @@
 //
 #include <doctest/doctest.h>
 //
+#include <lyrahgames/robin_hood/counting_allocator.hpp>
 #include <lyrahgames/robin_hood/flat_map.hpp>
 #include <lyrahgames/robin_hood/version.hpp>
 //
@@ -576,6 +578,38 @@ SCENARIO("robin_hood::flat_map::clear: Clear all Elements") {
   }
 }
 
+SCENARIO("robin_hood::flat_map::swap: Exchanging Contents") {
+  GIVEN("two maps with different elements and parameters") {
+    robin_hood::flat_map<int, int> first{{1, 1}, {2, 2}, {3, 3}};
+    robin_hood::flat_map<int, int> second{{4, 4}};
+    second.set_max_load_factor(0.5);
+    second.reserve_capacity(64);
+    const auto first_capacity  = first.capacity();
+    const auto second_capacity = second.capacity();
+    const auto first_keys      = &first.data().key(0);
+    const auto second_keys     = &second.data().key(0);
+
+    WHEN("swapping them") {
+      first.swap(second);
+
+      THEN("elements, capacities, and parameters are exchanged without "
+           "copying the tables.") {
+        CHECK(&first.data().key(0) == second_keys);
+        CHECK(&second.data().key(0) == first_keys);
+        CHECK(first.size() == 1);
+        CHECK(first(4) == 4);
+        CHECK(first.max_load_factor() == 0.5);
+        CHECK(first.capacity() == second_capacity);
+        CHECK(second.size() == 3);
+        CHECK(second(1) == 1);
+        CHECK(second(2) == 2);
+        CHECK(second(3) == 3);
+        CHECK(second.capacity() == first_capacity);
+      }
+    }
+  }
+}
+
 SCENARIO("robin_hood::flat_map: unique_ptr as Value Types") {
   random_device rng{};
   vector<int>   keys{};
@@ -973,4 +1007,676 @@ SCENARIO("robin_hood::flat_map:emplace: Emplacing Elements") {
       }
     }
   }
-}
\ No newline at end of file
+}
+
+namespace {
+
+struct colliding_hash {
+  size_t operator()(int) const noexcept { return 0; }
+};
+
+}  // namespace
+
+SCENARIO("robin_hood::flat_map::try_insert: Insertion Status") {
+  using robin_hood::insert_status;
+
+  GIVEN("a map with one element") {
+    robin_hood::flat_map<int, std::pair<int, int>> map{{1, {2, 3}}};
+
+    WHEN("trying to insert or emplace a new key") {
+      const auto [it, status]   = map.try_insert(2, std::pair{4, 5});
+      const auto [jt, emplaced] = map.try_emplace(3, 6, 7);
+      THEN("the elements are inserted and the iterators point to them.") {
+        CHECK(status == insert_status::inserted);
+        CHECK(emplaced == insert_status::inserted);
+        CHECK(map.size() == 3);
+        CHECK((*it).first == 2);
+        CHECK((*it).second == std::pair{4, 5});
+        CHECK((*jt).first == 3);
+        CHECK((*jt).second == std::pair{6, 7});
+      }
+    }
+
+    WHEN("trying to insert or emplace an existing key") {
+      const auto [it, status]   = map.try_insert(1, std::pair{4, 5});
+      const auto [jt, emplaced] = map.try_emplace(1, 6, 7);
+      THEN("nothing is inserted and the iterators point to the old element.") {
+        CHECK(status == insert_status::exists);
+        CHECK(emplaced == insert_status::exists);
+        CHECK(map.size() == 1);
+        CHECK(it == jt);
+        CHECK((*it).first == 1);
+        CHECK((*it).second == std::pair{2, 3});
+      }
+    }
+
+    WHEN("trying to statically insert into an overloaded map") {
+      auto status = insert_status::inserted;
+      for (int i = 2; status == insert_status::inserted; ++i)
+        status = map.try_static_insert(i, std::pair{i, i}).second;
+      const auto [it, again] = map.try_static_insert(-1, std::pair{0, 0});
+      THEN("the overload is reported without throwing an exception.") {
+        CHECK(again == insert_status::overloaded);
+        CHECK(it == map.end());
+        CHECK(!map.contains(-1));
+        CHECK_THROWS_AS(map.static_insert(-1, std::pair{0, 0}),
+                        std::overflow_error);
+      }
+    }
+  }
+
+  GIVEN("a map whose keys all collide and whose PSL is limited") {
+    robin_hood::flat_map<int, int, colliding_hash> map{};
+    map.reserve(64);
+    map.set_psl_limit(2);
+
+    WHEN("statically inserting more keys than the limit allows") {
+      const auto first       = map.try_static_insert(1, 1).second;
+      const auto second      = map.try_static_insert(2, 2).second;
+      const auto [it, third] = map.try_static_insert(3, 3);
+      THEN("the violation of the limit is reported without throwing.") {
+        CHECK(first == insert_status::inserted);
+        CHECK(second == insert_status::inserted);
+        CHECK(third == insert_status::psl_limit);
+        CHECK(it == map.end());
+        CHECK(map.size() == 2);
+        CHECK(map.max_psl() == 2);
+        CHECK_THROWS_AS(map.static_insert(3, 3), std::overflow_error);
+      }
+    }
+  }
+}
+
+SCENARIO("robin_hood::flat_map::get_or_insert_with: Lazy Value Construction") {
+  // The value type is not default constructible
+  // and can therefore not be used with 'operator[]'.
+  struct expensive {
+    explicit expensive(int x) : data(x) {}
+    int data;
+  };
+
+  GIVEN("a map with one element and a counting factory") {
+    robin_hood::flat_map<int, expensive> map{};
+    map.insert(1, expensive{2});
+    int  calls   = 0;
+    auto factory = [&calls] {
+      ++calls;
+      return expensive{10 * calls};
+    };
+
+    WHEN("accessing an existing key") {
+      auto& value = map.get_or_insert_with(1, factory);
+      THEN("its value is returned without invoking the factory.") {
+        CHECK(calls == 0);
+        CHECK(value.data == 2);
+        CHECK(map.size() == 1);
+      }
+    }
+
+    WHEN("accessing missing keys") {
+      auto& value = map.get_or_insert_with(2, factory);
+      value.data += 1;
+      for (int i = 3; i < 100; ++i)
+        map.get_or_insert_with(i, factory);
+      THEN("the factory is invoked once per key to insert the values.") {
+        CHECK(calls == 98);
+        CHECK(map.size() == 99);
+        CHECK(map(2).data == 11);
+        CHECK(map(99).data == 980);
+      }
+    }
+
+    WHEN("the factory throws an exception") {
+      auto failing = []() -> expensive { throw std::runtime_error("failed"); };
+      THEN("the exception is propagated and the map stays unchanged.") {
+        CHECK_THROWS_AS(map.get_or_insert_with(2, failing), std::runtime_error);
+        CHECK(map.size() == 1);
+        CHECK(!map.contains(2));
+        CHECK(map(1).data == 2);
+      }
+    }
+  }
+
+  GIVEN("a map of values which count their moves") {
+    struct tracked {
+      explicit tracked(int* m) : moves{m} {}
+      tracked(tracked&& x) noexcept : moves{x.moves} { ++*moves; }
+      tracked& operator=(tracked&& x) noexcept {
+        moves = x.moves;
+        ++*moves;
+        return *this;
+      }
+      int* moves;
+    };
+    robin_hood::flat_map<int, tracked> map{};
+    map.reserve(10);
+    int moves = 0;
+
+    WHEN("inserting a value returned by the factory") {
+      map.get_or_insert_with(1, [&moves] { return tracked{&moves}; });
+      THEN("it is constructed in place without being moved.") {
+        CHECK(moves == 0);
+        CHECK(map.contains(1));
+      }
+    }
+  }
+
+  GIVEN("a map with many elements") {
+    robin_hood::flat_map<int, string> map{};
+    for (int i = 0; i < 1000; ++i)
+      map.insert(i, to_string(i));
+
+    WHEN("the factory throws for keys which displace other elements") {
+      auto failing = []() -> string { throw std::runtime_error("failed"); };
+      for (int i = 1000; i < 1100; ++i)
+        CHECK_THROWS_AS(map.get_or_insert_with(i, failing), std::runtime_error);
+      THEN("the keys are removed again and all other elements are kept.") {
+        CHECK(map.size() == 1000);
+        for (int i = 0; i < 1000; ++i)
+          CHECK(map(i) == to_string(i));
+        for (int i = 1000; i < 1100; ++i)
+          CHECK(!map.contains(i));
+      }
+    }
+  }
+}
+
+SCENARIO("robin_hood::flat_map::merge: Combining Values in a Single Probe") {
+  GIVEN("a map counting words") {
+    robin_hood::flat_map<string, int> map{{"a", 1}};
+
+    WHEN("merging counts by a function that returns the combined value") {
+      const auto& a = map.merge("a", 2, std::plus{});
+      const auto& b = map.merge(string{"b"}, 3, std::plus{});
+      THEN("existing values are replaced by the result and new keys are "
+           "inserted with the given value.") {
+        CHECK(a == 3);
+        CHECK(b == 3);
+        CHECK(map.size() == 2);
+        CHECK(map("a") == 3);
+        CHECK(map("b") == 3);
+      }
+    }
+
+    WHEN("merging counts by a function that modifies values in place") {
+      for (int i = 0; i < 5; ++i)
+        map.merge("a", 1, [](int& x, int y) { x += y; });
+      THEN("the existing value is modified.") {
+        CHECK(map.size() == 1);
+        CHECK(map("a") == 6);
+      }
+    }
+
+    WHEN("merging a whole range of pairs with many equal keys") {
+      vector<pair<string, int>> words{};
+      for (int i = 0; i < 1000; ++i)
+        words.push_back({to_string(i % 10), 1});
+      map.merge(words, std::plus{});
+      THEN("every key is counted once for each of its occurrences.") {
+        CHECK(map.size() == 11);
+        CHECK(map("a") == 1);
+        for (int i = 0; i < 10; ++i)
+          CHECK(map(to_string(i)) == 100);
+      }
+    }
+  }
+
+  GIVEN("a map of lists") {
+    robin_hood::flat_map<int, vector<int>> map{};
+
+    WHEN("upserting elements") {
+      const auto append = [](vector<int>& list) {
+        list.push_back(int(list.size()));
+      };
+      for (int i = 0; i < 3; ++i)
+        map.upsert(i % 2, vector<int>{-1}, append);
+      const auto& list = map.upsert(2, vector<int>{}, append);
+      THEN("missing keys are initialized and existing ones are updated.") {
+        CHECK(map.size() == 3);
+        CHECK(map(0) == vector<int>{-1, 1});
+        CHECK(map(1) == vector<int>{-1});
+        CHECK(list.empty());
+      }
+    }
+  }
+}
+
+namespace {
+
+struct counting_hash {
+  size_t operator()(const string& x) const noexcept {
+    ++calls;
+    return std::hash<string>{}(x);
+  }
+  static inline size_t calls = 0;
+};
+
+}  // namespace
+
+SCENARIO("robin_hood::flat_map::hashed: Prehashed Lookup and Insertion") {
+  GIVEN("a map of strings and keys whose hash values have been computed") {
+    robin_hood::flat_map<string, int, counting_hash> map{};
+    map.reserve(64);
+    vector<string> keys{};
+    for (int i = 0; i < 32; ++i)
+      keys.push_back("key number " + to_string(i));
+    vector<robin_hood::hashed_key<string>> hashed{};
+    for (const auto& key : keys)
+      hashed.push_back(map.hashed(key));
+    counting_hash::calls = 0;
+
+    WHEN("inserting, looking up, and removing elements by these keys") {
+      for (int i = 0; i < 32; ++i)
+        map.insert(hashed[i], i);
+      const auto [it, status] = map.try_insert(hashed[3], -1);
+      bool found = true;
+      for (int i = 0; i < 32; ++i)
+        found &= map.contains(hashed[i]) && (map(hashed[i]) == i) &&
+                 ((*map.lookup(hashed[i])).second == i);
+      for (int i = 0; i < 16; ++i)
+        map.remove(hashed[i]);
+      map.try_remove(hashed[0]);
+      THEN("the hasher is never called and the results equal the ones of "
+           "the usual functions.") {
+        CHECK(counting_hash::calls == 0);
+        CHECK(found);
+        CHECK(status == robin_hood::insert_status::exists);
+        CHECK((*it).second == 3);
+        CHECK(map.size() == 16);
+        CHECK_THROWS_AS(map.insert(hashed[16], 0), std::invalid_argument);
+        CHECK_THROWS_AS(map.remove(hashed[0]), std::invalid_argument);
+        for (int i = 0; i < 32; ++i)
+          CHECK(map.contains(keys[i]) == (i >= 16));
+      }
+    }
+
+    WHEN("inserting more elements than the table can take without growing") {
+      for (const auto& key : hashed)
+        map.insert(key, 0);
+      for (int i = 32; i < 256; ++i) {
+        auto       key    = to_string(i);
+        const auto hashed = map.hashed(key);
+        map.insert(std::move(key), hashed, i);
+      }
+      THEN("the table is rehashed and all elements are found.") {
+        CHECK(map.size() == 256);
+        for (int i = 32; i < 256; ++i)
+          CHECK(map(to_string(i)) == i);
+        for (const auto& key : hashed)
+          CHECK(map(key) == 0);
+      }
+    }
+
+    WHEN("inserting keys by moving them together with their hash values") {
+      auto       key    = string(32, 'x');
+      auto       copy   = key;
+      const auto hashed = map.hashed(copy);
+
+      counting_hash::calls    = 0;
+      const auto [it, status] = map.try_insert(std::move(key), hashed, 1);
+      const auto [jt, exists] = map.try_insert(std::move(copy), hashed, 2);
+      THEN("inserted keys are moved, existing ones are kept, and the hasher "
+           "is not called.") {
+        CHECK(counting_hash::calls == 0);
+        CHECK(status == robin_hood::insert_status::inserted);
+        CHECK(key.empty());
+        CHECK(exists == robin_hood::insert_status::exists);
+        CHECK(copy == string(32, 'x'));
+        CHECK(it == jt);
+        CHECK((*it).second == 1);
+      }
+    }
+
+    THEN("temporary keys cannot be hashed.") {
+      const auto hashable = [](auto& m) {
+        return requires { m.hashed(string{}); };
+      };
+      static_assert(!hashable(map));
+    }
+  }
+}
+
+SCENARIO("robin_hood::flat_map::for_each: Parallel Iteration") {
+  namespace execution = robin_hood::execution;
+
+  GIVEN("a map with many elements") {
+    robin_hood::flat_map<int, int> map{};
+    const int                      n = 100000;
+    for (int i = 0; i < n; ++i)
+      map.insert(i, 2 * i);
+
+    WHEN("modifying all values with a parallel execution policy") {
+      map.for_each(execution::par, [](auto&& element) {
+        auto& [key, value] = element;
+        value += key;
+      });
+
+      THEN("every value has been modified exactly once.") {
+        for (int i = 0; i < n; ++i)
+          CHECK(map(i) == 3 * i);
+      }
+    }
+
+    WHEN("aggregating the elements with different execution policies") {
+      const auto sum = [](auto x, auto y) { return x + y; };
+      const auto f   = [](auto&& element) {
+        const auto& [key, value] = element;
+        return size_t(value) - size_t(key);
+      };
+      const auto seq = map.transform_reduce(execution::seq, size_t{7}, sum, f);
+      const auto par = map.transform_reduce(execution::par, size_t{7}, sum, f);
+
+      THEN("the results are the same.") {
+        CHECK(seq == 7 + size_t(n - 1) * n / 2);
+        CHECK(par == seq);
+      }
+    }
+
+    WHEN("dividing the table into more chunks than hardware threads") {
+      const auto     size = map.capacity();
+      vector<size_t> counts(5);
+      robin_hood::detail::parallel::for_each_chunk(
+          counts.size(), size, [&](size_t chunk, size_t first, size_t last) {
+            counts[chunk] = last - first;
+          });
+
+      THEN("the chunks cover the whole table.") {
+        size_t total = 0;
+        for (auto c : counts)
+          total += c;
+        CHECK(total == size);
+      }
+    }
+  }
+}
+
+SCENARIO("robin_hood::flat_map: Parallel Copy and Destruction") {
+  namespace execution = robin_hood::execution;
+
+  GIVEN("a map with many non-trivial values") {
+    robin_hood::flat_map<int, string> map{};
+    const int                         n = 50000;
+    for (int i = 0; i < n; ++i)
+      map.insert(i, string(40, 'a' + i % 26));
+
+    WHEN("copying it with a parallel execution policy") {
+      robin_hood::flat_map<int, string> copy(execution::par, map);
+
+      THEN("the copy contains the same elements.") {
+        CHECK(copy.size() == map.size());
+        CHECK(copy.capacity() == map.capacity());
+        for (int i = 0; i < n; ++i)
+          CHECK(copy(i) == map(i));
+      }
+    }
+
+    WHEN("clearing it with a parallel execution policy") {
+      const auto capacity = map.capacity();
+      map.clear(execution::par);
+
+      THEN("it is empty but keeps its capacity.") {
+        CHECK(map.empty());
+        CHECK(map.capacity() == capacity);
+        CHECK(!map.contains(0));
+      }
+    }
+
+    WHEN("disposing its contents on a background thread") {
+      auto done = map.dispose_async();
+      map.insert(-1, "new");
+
+      THEN("the map can be used immediately and the old elements are freed.") {
+        CHECK(map.size() == 1);
+        CHECK(map(-1) == "new");
+        CHECK(!map.contains(0));
+        done.get();
+      }
+    }
+  }
+}
+
+SCENARIO("robin_hood::flat_map: Polymorphic Allocators and Arenas") {
+  using allocator = pmr::polymorphic_allocator<int>;
+  using map_type  = robin_hood::flat_map<int, pmr::string, hash<int>,
+                                        equal_to<int>, allocator>;
+
+  GIVEN("a map whose memory comes from a monotonic arena without upstream") {
+    vector<byte>                   buffer(1 << 20);
+    pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size(),
+                                         pmr::null_memory_resource()};
+    map_type                       map(8, allocator{&arena});
+    const auto value = [](int i) {
+      return pmr::string(to_string(i) + string(40, 'x'));
+    };
+    for (int i = 0; i < 1000; ++i)
+      map.insert(i, value(i));
+
+    CHECK(map.get_allocator().resource() == &arena);
+
+    THEN("values are constructed with the allocator of the map.") {
+      for (int i = 0; i < 1000; ++i) {
+        CHECK(map(i) == value(i));
+        CHECK(map(i).get_allocator().resource() == &arena);
+      }
+    }
+
+    WHEN("copying the map") {
+      const auto copy = map;
+
+      THEN("the copy uses the default resource as the standard demands.") {
+        CHECK(copy.get_allocator().resource() == pmr::get_default_resource());
+        CHECK(copy.size() == map.size());
+        for (int i = 0; i < 1000; ++i)
+          CHECK(copy(i) == map(i));
+      }
+    }
+
+    WHEN("move assigning the map to a map with another resource") {
+      map_type other(8, allocator{pmr::new_delete_resource()});
+      other.insert(-1, "old");
+      other = std::move(map);
+
+      THEN("the elements are moved one by one into memory of the target.") {
+        CHECK(other.get_allocator().resource() == pmr::new_delete_resource());
+        CHECK(other.size() == 1000);
+        CHECK(!other.contains(-1));
+        for (int i = 0; i < 1000; ++i) {
+          CHECK(other(i) == value(i));
+          CHECK(other(i).get_allocator().resource() ==
+                pmr::new_delete_resource());
+        }
+      }
+    }
+
+    WHEN("releasing the map instead of destroying its elements") {
+      map.release();
+
+      THEN("it is empty and can still be used.") {
+        CHECK(map.empty());
+        CHECK(!map.contains(0));
+        map.insert(1, "new");
+        CHECK(map(1) == "new");
+        map.release();
+      }
+    }
+  }
+}
+
+SCENARIO("robin_hood::flat_map::shrink_to_fit: Giving Back Memory") {
+  GIVEN("a map after a burst of insertions followed by removals") {
+    robin_hood::flat_map<int, int> map{};
+    for (int i = 0; i < 10000; ++i)
+      map.insert(i, i);
+    const auto peak = map.capacity();
+    for (int i = 100; i < 10000; ++i)
+      map.remove(i);
+
+    CHECK(map.capacity() == peak);
+    CHECK(map.min_load_factor() == 0);
+
+    WHEN("shrinking it to fit") {
+      map.shrink_to_fit();
+
+      THEN("the capacity is the one reserve would choose and no element is "
+           "lost.") {
+        CHECK(map.capacity() == 128);
+        CHECK(map.size() == 100);
+        for (int i = 0; i < 100; ++i)
+          CHECK(map(i) == i);
+      }
+    }
+  }
+
+  GIVEN("a map with a minimum load factor") {
+    robin_hood::flat_map<int, int> map{};
+    map.set_min_load_factor(0.1);
+    CHECK(map.min_load_factor() == 0.1);
+    for (int i = 0; i < 10000; ++i)
+      map.insert(i, i);
+
+    WHEN("removing most of the elements by their keys") {
+      for (int i = 0; i < 9900; ++i)
+        map.try_remove(i);
+
+      THEN("the map has shrunk automatically and keeps all other elements.") {
+        CHECK(map.size() == 100);
+        CHECK(map.load_factor() >= map.min_load_factor());
+        CHECK(map.load_factor() <= map.max_load_factor() / 2);
+        for (int i = 9900; i < 10000; ++i)
+          CHECK(map(i) == i);
+      }
+    }
+
+    WHEN("alternately inserting and removing an element at the boundary") {
+      for (int i = 0; i < 9000; ++i)
+        map.remove(i);
+      const auto capacity = map.capacity();
+      for (int i = 0; i < 100; ++i) {
+        map.insert(-1, 0);
+        map.remove(-1);
+      }
+
+      THEN("the capacity does not thrash.") {
+        CHECK(map.capacity() == capacity);
+      }
+    }
+  }
+}
+
+SCENARIO("robin_hood::flat_map::memory_usage: Memory Accounting") {
+  using allocator_type = robin_hood::counting_allocator<string>;
+  using map_type = robin_hood::flat_map<string, string, hash<string>,
+                                        equal_to<string>, allocator_type>;
+
+  GIVEN("a map with a counting allocator") {
+    const auto before = robin_hood::allocation_counter::bytes();
+    map_type   map{};
+
+    WHEN("inserting strings which own memory of their own") {
+      for (int i = 0; i < 100; ++i)
+        map.insert(to_string(i), string(100, 'x'));
+
+      const auto usage = map.memory_usage();
+
+      THEN("the table bytes are accounted by capacity and match the bytes "
+           "actually allocated by the map.") {
+        CHECK(usage.elements == map.size());
+        CHECK(usage.key_bytes == map.capacity() * sizeof(string));
+        CHECK(usage.value_bytes == map.capacity() * sizeof(string));
+        CHECK(usage.owned_bytes == 0);
+        CHECK(usage.total_bytes() == usage.table_bytes());
+        CHECK(robin_hood::allocation_counter::bytes() - before ==
+              usage.table_bytes());
+      }
+
+      THEN("a hook accounts the memory owned by the elements.") {
+        const auto owned = map.memory_usage([](const auto& entry) {
+          return entry.first.capacity() + entry.second.capacity();
+        });
+        CHECK(owned.table_bytes() == usage.table_bytes());
+        CHECK(owned.owned_bytes >= 100 * 100);
+        CHECK(owned.bytes_per_element() ==
+              double(owned.total_bytes()) / owned.elements);
+      }
+    }
+
+    WHEN("the map is destroyed") {
+      { const auto trash = std::move(map); }
+
+      THEN("all memory is given back.") {
+        CHECK(robin_hood::allocation_counter::bytes() ==
+              before + map.memory_usage().table_bytes());
+      }
+    }
+  }
+}
+
+namespace {
+
+// Seeded hasher whose initial seed is known to an attacker
+// who is able to make all keys collide.
+struct compromised_hash {
+  size_t operator()(const uint64_t& x) const noexcept {
+    if (seed == 0) return 0;
+    return robin_hood::hash<uint64_t>::seeded(x, seed);
+  }
+  void reseed(uint64_t s) noexcept { seed = s; }
+  uint64_t seed = 0;
+};
+
+}  // namespace
+
+SCENARIO("robin_hood::flat_map::set_psl_limit: Bounded Probe Lengths") {
+  GIVEN("a map whose seeded hasher lets all keys collide") {
+    robin_hood::flat_map<uint64_t, uint64_t, compromised_hash> map{};
+    for (uint64_t i = 0; i < 10; ++i)
+      map.insert(i, 2 * i);
+
+    WHEN("setting a PSL limit") {
+      map.set_psl_limit(8);
+
+      THEN("the hasher is reseeded to keep the limit.") {
+        CHECK(map.reseed_count() == 1);
+        CHECK(map.max_psl() <= 8);
+        for (uint64_t i = 0; i < 10; ++i)
+          CHECK(map(i) == 2 * i);
+      }
+    }
+  }
+}
+
+SCENARIO("robin_hood::flat_map::hashed: Stale Hash Values After Reseeding") {
+  GIVEN("a map whose seeded hasher lets all keys collide and hashed keys") {
+    robin_hood::flat_map<uint64_t, uint64_t, compromised_hash> map{};
+    map.reserve(1024);
+    vector<uint64_t> keys{};
+    for (uint64_t i = 0; i < 200; ++i)
+      keys.push_back(i);
+    vector<robin_hood::hashed_key<uint64_t>> hashed{};
+    for (const auto& key : keys)
+      hashed.push_back(map.hashed(key));
+
+    WHEN("inserting them until hash flooding reseeds the hasher") {
+      for (uint64_t i = 0; i < 100; ++i)
+        map.insert(hashed[i], i);
+      for (uint64_t i = 100; i < 200; ++i) {
+        auto key = keys[i];
+        map.insert(std::move(key), hashed[i], i);
+      }
+
+      THEN("the stale hash values are recomputed and no key is lost.") {
+        CHECK(map.reseed_count() == 1);
+        CHECK(map.size() == 200);
+        for (uint64_t i = 0; i < 200; ++i) {
+          CHECK(map(keys[i]) == i);
+          CHECK(map(hashed[i]) == i);
+          CHECK(map.try_insert(hashed[i], 0).second ==
+                robin_hood::insert_status::exists);
+        }
+        for (const auto& key : hashed)
+          map.remove(key);
+        CHECK(map.empty());
+      }
+    }
+  }
+}
@@ -1,6 +1,9 @@
+#include <cstdint>
 #include <iomanip>
 #include <iostream>
 #include <random>
+#include <stdexcept>
+#include <string>
 #include <vector>
 //
 #include <doctest/doctest.h>
@@ -195,4 +198,130 @@ SCENARIO("robin_hood::flat_set::static_insert: Statistics for Key Type") {
       }
     }
   }
-}
\ No newline at end of file
+}
+
+SCENARIO("robin_hood::flat_set::transform_reduce: Parallel Aggregation") {
+  namespace execution = robin_hood::execution;
+
+  GIVEN("a set with many elements") {
+    robin_hood::flat_set<int> set{};
+    for (int i = 1; i <= 50000; ++i)
+      set.insert(i);
+
+    THEN("counting and summing in parallel gives the serial results.") {
+      size_t count = 0;
+      set.for_each(execution::seq, [&](int) { ++count; });
+      CHECK(count == set.size());
+      CHECK(set.transform_reduce(
+                execution::par, size_t{0}, plus<size_t>{},
+                [](int x) { return size_t(x); }) == size_t{50000} * 50001 / 2);
+    }
+  }
+}
+
+SCENARIO("robin_hood::flat_set::hashed: Prehashed Insertion and Removal") {
+  GIVEN("a set and a key together with its hash value") {
+    robin_hood::flat_set<int> set{};
+    const int  key    = 42;
+    const auto hashed = set.hashed(key);
+    CHECK(hashed.hash == std::hash<int>{}(key));
+
+    WHEN("inserting and removing the key by its hash value") {
+      const auto [it, status] = set.try_insert(hashed);
+      THEN("the set behaves as for the key itself.") {
+        CHECK(status == robin_hood::insert_status::inserted);
+        CHECK(*it == key);
+        CHECK(set.contains(key));
+        CHECK(set.contains(hashed));
+        CHECK(set.lookup(hashed) == set.lookup(key));
+        CHECK(set.try_insert(hashed).second ==
+              robin_hood::insert_status::exists);
+        CHECK_THROWS_AS(set.insert(hashed), std::invalid_argument);
+        set.remove(hashed);
+        CHECK(set.empty());
+        CHECK(!set.contains(hashed));
+      }
+    }
+  }
+
+  GIVEN("a set of strings and a key together with its hash value") {
+    robin_hood::flat_set<std::string> set{};
+    auto       key    = std::string(32, 'x');
+    const auto copy   = key;
+    const auto hashed = set.hashed(copy);
+
+    WHEN("inserting the key by moving it") {
+      const auto [it, status] = set.try_insert(std::move(key), hashed);
+      THEN("the key is moved into the set.") {
+        CHECK(status == robin_hood::insert_status::inserted);
+        CHECK(key.empty());
+        CHECK(*it == std::string(32, 'x'));
+        CHECK_THROWS_AS(set.insert(std::string(32, 'x'), hashed),
+                        std::invalid_argument);
+      }
+    }
+  }
+}
+
+namespace {
+
+struct constant_hash {
+  size_t operator()(const uint64_t&) const noexcept { return 0; }
+};
+
+}  // namespace
+
+SCENARIO("robin_hood::flat_set::set_psl_limit: Bounded Probe Lengths") {
+  GIVEN("a set with a PSL limit") {
+    robin_hood::flat_set<uint64_t, robin_hood::hash<uint64_t>> set{};
+    set.set_psl_limit(4);
+    CHECK(set.psl_limit() == 4);
+
+    WHEN("inserting many keys") {
+      for (uint64_t i = 0; i < 10000; ++i)
+        set.insert(i * i);
+
+      THEN("no element exceeds the limit and all of them are found.") {
+        CHECK(set.size() == 10000);
+        CHECK(set.max_psl() <= 4);
+        for (uint64_t i = 0; i < 10000; ++i)
+          CHECK(set.contains(i * i));
+        CHECK(!set.contains(3));
+      }
+    }
+  }
+
+  GIVEN("a set with an unseeded hasher that lets all keys collide") {
+    robin_hood::flat_set<uint64_t, constant_hash> set{};
+    set.set_psl_limit(4);
+    for (uint64_t i = 0; i < 4; ++i)
+      set.insert(i);
+
+    THEN("exceeding the limit cannot be prevented and throws without "
+         "growing the set.") {
+      const auto capacity = set.capacity();
+      CHECK_THROWS_AS(set.static_insert(4), std::overflow_error);
+      CHECK_THROWS_AS(set.insert(4), std::overflow_error);
+      CHECK(set.capacity() == capacity);
+      CHECK(set.psl_limit() == 4);
+      CHECK(set.size() == 4);
+      for (uint64_t i = 0; i < 4; ++i)
+        CHECK(set.contains(i));
+      CHECK(!set.contains(4));
+    }
+
+    WHEN("removing the limit") {
+      set.set_psl_limit(0);
+      for (uint64_t i = 4; i < 10; ++i)
+        set.insert(i);
+
+      THEN("a stricter limit cannot be set and is removed again.") {
+        CHECK(set.max_psl() == 10);
+        CHECK_THROWS_AS(set.set_psl_limit(4), std::overflow_error);
+        CHECK(set.psl_limit() == 0);
+        for (uint64_t i = 0; i < 10; ++i)
+          CHECK(set.contains(i));
+      }
+    }
+  }
+}
@@ -0,0 +1,96 @@
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+//
+#include <doctest/doctest.h>
+//
+#include <lyrahgames/robin_hood/frozen_map.hpp>
+#include <lyrahgames/robin_hood/hash.hpp>
+
+using namespace std;
+using namespace lyrahgames;
+
+namespace {
+
+constexpr auto keywords = robin_hood::make_frozen_map<string_view, int>({
+    {"if", 1},
+    {"else", 2},
+    {"for", 3},
+    {"while", 4},
+    {"do", 5},
+    {"switch", 6},
+    {"case", 7},
+    {"default", 8},
+    {"break", 9},
+    {"continue", 10},
+    {"return", 11},
+    {"a_keyword_that_is_longer_than_sixteen_bytes", 12},
+});
+
+constexpr auto squares = [] {
+  array<pair<uint64_t, uint64_t>, 500> elements{};
+  for (uint64_t i = 0; i < elements.size(); ++i)
+    elements[i] = {i * i, i};
+  return robin_hood::frozen_map<uint64_t, uint64_t, 500>{elements};
+}();
+
+// The whole table is built and queried at compile time.
+static_assert(keywords.size() == 12);
+static_assert(keywords("while") == 4);
+static_assert(keywords("a_keyword_that_is_longer_than_sixteen_bytes") == 12);
+static_assert(!keywords.contains("elif"));
+static_assert(squares(49 * 49) == 49);
+static_assert(!squares.contains(2));
+
+}  // namespace
+
+SCENARIO("robin_hood::frozen_map: Compile-Time Perfect Hashing") {
+  GIVEN("frozen maps built in constant expressions") {
+    THEN("hash values computed at runtime find the same elements.") {
+      for (const auto& [key, value] : keywords) {
+        REQUIRE(keywords.contains(string{key}));
+        CHECK(keywords(string{key}) == value);
+        CHECK(keywords.lookup(key)->second == value);
+      }
+      CHECK(!keywords.contains(""));
+      CHECK(keywords.lookup("iff") == keywords.end());
+      CHECK_THROWS_AS(keywords("iff"), std::invalid_argument);
+
+      for (uint64_t i = 0; i < 1000 * 1000; ++i) {
+        const auto it = squares.lookup(i);
+        if (it == squares.end()) continue;
+        CHECK(it->first == i);
+        CHECK(it->second * it->second == i);
+      }
+      CHECK(squares.contains(499 * 499));
+    }
+
+    THEN("the hash values used at compile and runtime are equal.") {
+      constexpr auto h = robin_hood::hash<string_view>{}("continue");
+      const auto     s = string{"continue"};
+      CHECK(robin_hood::hash<string_view>{}(s) == h);
+    }
+  }
+
+  GIVEN("an empty frozen map") {
+    constexpr auto elements = array<pair<int, int>, 0>{};
+    constexpr auto map      = robin_hood::frozen_map<int, int, 0>{elements};
+
+    THEN("it contains nothing.") {
+      CHECK(map.empty());
+      CHECK(map.begin() == map.end());
+      CHECK(!map.contains(0));
+    }
+  }
+
+  GIVEN("elements with duplicate keys") {
+    THEN("the construction at runtime throws.") {
+      CHECK_THROWS_AS((robin_hood::make_frozen_map<int, int>(
+                          {{1, 1}, {2, 2}, {1, 3}})),
+                      std::invalid_argument);
+    }
+  }
+}
@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+//
+#include <doctest/doctest.h>
+//
+#include <lyrahgames/robin_hood/capacity.hpp>
+#include <lyrahgames/robin_hood/flat_map.hpp>
+#include <lyrahgames/robin_hood/flat_set.hpp>
+#include <lyrahgames/robin_hood/hash.hpp>
+#include <lyrahgames/robin_hood/meta.hpp>
+
+using namespace std;
+using namespace lyrahgames;
+
+namespace {
+
+struct point {
+  float x, y, z;
+  constexpr bool operator==(const point&) const noexcept = default;
+};
+
+enum class color : uint8_t { red, green, blue };
+
+// Seeded hasher whose initial seed is known to an attacker
+// who is able to make all keys collide.
+struct compromised_hash {
+  size_t operator()(const uint64_t& x) const noexcept {
+    if (seed == 0) return 0;
+    return robin_hood::hash<uint64_t>::seeded(x, seed);
+  }
+  void reseed(uint64_t s) noexcept { seed = s; }
+  uint64_t seed = 0;
+};
+
+struct constant_hash {
+  size_t operator()(const uint64_t&) const noexcept { return 0; }
+};
+
+}  // namespace
+
+SCENARIO("robin_hood::hash: Fast Hash Functions for Common Key Types") {
+  static_assert(robin_hood::generic::hasher<robin_hood::hash<int>, int>);
+  static_assert(
+      robin_hood::generic::hasher<robin_hood::hash<uint64_t>, uint64_t>);
+  static_assert(robin_hood::generic::hasher<robin_hood::hash<string>, string>);
+  static_assert(
+      robin_hood::generic::hasher<robin_hood::hash<string_view>, string_view>);
+  static_assert(
+      robin_hood::generic::hasher<robin_hood::pod_hash<point>, point>);
+
+  GIVEN("strings of all lengths up to a few hundred bytes") {
+    string str{};
+    for (size_t i = 0; i < 300; ++i)
+      str += char('a' + i % 26);
+
+    THEN("different lengths and single changed bytes lead to different hash "
+         "values and strings agree with their views.") {
+      const robin_hood::hash<string>      hash{};
+      const robin_hood::hash<string_view> view_hash{};
+      unordered_set<size_t>               values{};
+      for (size_t n = 0; n <= str.size(); ++n) {
+        const auto s = str.substr(0, n);
+        const auto h = hash(s);
+        CHECK(h == view_hash(s));
+        values.insert(h);
+        for (size_t i = 0; i < n; ++i) {
+          auto t = s;
+          ++t[i];
+          REQUIRE(hash(t) != h);
+        }
+      }
+      CHECK(values.size() == str.size() + 1);
+    }
+  }
+
+  GIVEN("integers differing in a single bit") {
+    const robin_hood::hash<uint64_t> hash{};
+
+    THEN("about half of the bits of their hash values differ.") {
+      size_t flips = 0;
+      size_t count = 0;
+      for (uint64_t x = 0; x < 1000; ++x) {
+        for (int bit = 0; bit < 64; ++bit) {
+          flips += popcount(hash(x) ^ hash(x ^ (uint64_t{1} << bit)));
+          ++count;
+        }
+      }
+      const auto mean = double(flips) / count;
+      CHECK(28 < mean);
+      CHECK(mean < 36);
+    }
+  }
+
+  GIVEN("other fixed-size keys") {
+    THEN("enums, pointers, PODs, and byte spans can be hashed.") {
+      CHECK(robin_hood::hash<color>{}(color::red) !=
+            robin_hood::hash<color>{}(color::blue));
+      int a, b;
+      CHECK(robin_hood::hash<int*>{}(&a) != robin_hood::hash<int*>{}(&b));
+      const robin_hood::pod_hash<point> point_hash{};
+      CHECK(point_hash({1, 2, 3}) == point_hash({1, 2, 3}));
+      CHECK(point_hash({1, 2, 3}) != point_hash({3, 2, 1}));
+      const string str   = "bytes";
+      const auto   bytes = as_bytes(span{str.data(), str.size()});
+      CHECK(robin_hood::hash<span<const byte>>{}(bytes) ==
+            robin_hood::hash<string>{}(str));
+    }
+  }
+
+  GIVEN("a map with string keys and the arbitrary capacity policy") {
+    robin_hood::flat_map<string, int, robin_hood::hash<string>,
+                         equal_to<string>, allocator<string>,
+                         robin_hood::unsynchronized,
+                         robin_hood::arbitrary_capacity<>>
+        map{};
+    for (int i = 0; i < 10000; ++i)
+      map.insert("https://example.com/" + to_string(i), i);
+
+    THEN("all elements are found and probe sequences stay short.") {
+      for (int i = 0; i < 10000; ++i) {
+        const auto [index, psl, found] =
+            map.lookup_data("https://example.com/" + to_string(i));
+        REQUIRE(found);
+        CHECK(psl < 32);
+      }
+    }
+  }
+}
+
+SCENARIO("robin_hood::seeded_hash: Reseeding on Hash Flooding") {
+  GIVEN("seeded hashers") {
+    robin_hood::seeded_hash<string> a{};
+    robin_hood::seeded_hash<string> b{};
+
+    THEN("they start with different seeds and their values depend on it.") {
+      CHECK(a.seed != b.seed);
+      CHECK(a("key") != b("key"));
+      b.reseed(a.seed);
+      CHECK(a("key") == b("key"));
+    }
+  }
+
+  GIVEN("a map whose seeded hasher lets all keys collide") {
+    robin_hood::flat_map<uint64_t, uint64_t, compromised_hash> map{};
+    map.reserve(10000);
+
+    WHEN("inserting many keys at a low load factor") {
+      for (uint64_t i = 0; i < 1000; ++i)
+        map.insert(i, 2 * i);
+
+      THEN("the flooding is detected and the map picks a new seed.") {
+        CHECK(map.reseed_count() == 1);
+        size_t max_psl = 0;
+        for (uint64_t i = 0; i < 1000; ++i) {
+          const auto [index, psl, found] = map.lookup_data(i);
+          REQUIRE(found);
+          CHECK(map(i) == 2 * i);
+          max_psl = max(max_psl, size_t(psl));
+        }
+        CHECK(max_psl < 16);
+      }
+    }
+
+    WHEN("reseeding the map explicitly") {
+      for (uint64_t i = 0; i < 10; ++i)
+        map.insert(i, i);
+      map.reseed();
+
+      THEN("all elements are kept and the counter is incremented.") {
+        CHECK(map.reseed_count() == 1);
+        CHECK(map.size() == 10);
+        for (uint64_t i = 0; i < 10; ++i)
+          CHECK(map(i) == i);
+      }
+    }
+  }
+
+  GIVEN("a set with an unseeded hasher that lets all keys collide") {
+    robin_hood::flat_set<uint64_t, constant_hash> set{};
+    set.reserve(10000);
+    for (uint64_t i = 0; i < 200; ++i)
+      set.insert(i);
+
+    THEN("no reseeding takes place.") {
+      CHECK(set.reseed_count() == 0);
+      for (uint64_t i = 0; i < 200; ++i)
+        CHECK(set.contains(i));
+    }
+  }
+}
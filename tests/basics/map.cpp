@@ -1376,4 +1376,45 @@ SCENARIO("robin_hood::map::insert: Using Ranges for Insertion") {
       CHECK(map(5) == 5);
     }
   }
-}
\ No newline at end of file
+}
+
+SCENARIO("robin_hood::map::shrink_to_fit: Giving Back Memory") {
+  GIVEN("a map after many removals") {
+    robin_hood::map<int, int> map{};
+    for (int i = 0; i < 1000; ++i)
+      map.insert(i, i);
+    for (int i = 10; i < 1000; ++i)
+      map.erase(i);
+
+    WHEN("shrinking it to fit") {
+      map.shrink_to_fit();
+
+      THEN("the capacity is minimal and all elements remain.") {
+        CHECK(map.capacity() == 16);
+        CHECK(map.size() == 10);
+        for (int i = 0; i < 10; ++i)
+          CHECK(map(i) == i);
+      }
+    }
+  }
+}
+
+SCENARIO("robin_hood::map::memory_usage: Memory Accounting") {
+  GIVEN("a map of strings") {
+    robin_hood::map<int, string> map{};
+    for (int i = 0; i < 50; ++i)
+      map[i] = string(64, 'x');
+
+    THEN("the table bytes are accounted by capacity and the owned bytes are "
+         "given by the hook.") {
+      const auto usage = map.memory_usage(
+          [](int, const string& value) { return value.capacity(); });
+      CHECK(usage.elements == map.size());
+      CHECK(usage.key_bytes == map.capacity() * sizeof(int));
+      CHECK(usage.value_bytes == map.capacity() * sizeof(string));
+      CHECK(usage.owned_bytes >= 50 * 64);
+      CHECK(usage.total_bytes() == usage.table_bytes() + usage.owned_bytes);
+      CHECK(map.memory_usage().owned_bytes == 0);
+    }
+  }
+}
@@ -0,0 +1,147 @@
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+//
+#include <doctest/doctest.h>
+//
+#include <lyrahgames/robin_hood/flat_map.hpp>
+#include <lyrahgames/robin_hood/flat_set.hpp>
+#include <lyrahgames/robin_hood/mapped_flat_map.hpp>
+#include <lyrahgames/robin_hood/mapped_flat_set.hpp>
+
+using namespace std;
+using namespace lyrahgames;
+
+SCENARIO("robin_hood::mapped_flat_map: Memory-Mapped Tables") {
+  const auto path =
+      filesystem::temp_directory_path() / "robin_hood_mapped_file_test.bin";
+  mt19937 rng{random_device{}()};
+
+  GIVEN("a flat map that has been saved to a file") {
+    robin_hood::flat_map<uint64_t, uint64_t> map{};
+    for (size_t i = 0; i < 10000; ++i)
+      map[rng()] = i;
+    robin_hood::save_mapped(map, path);
+
+    WHEN("the file is mapped") {
+      robin_hood::mapped_flat_map<uint64_t, uint64_t> mapped{path};
+
+      THEN("the view finds all elements at the same positions.") {
+        CHECK(mapped.size() == map.size());
+        CHECK(mapped.capacity() == map.capacity());
+        for (const auto& [key, value] : map) {
+          REQUIRE(mapped.contains(key));
+          CHECK(mapped(key) == value);
+          CHECK((*mapped.lookup(key)).second == value);
+        }
+        size_t count = 0;
+        for (const auto& [key, value] : mapped) {
+          CHECK(map(key) == value);
+          ++count;
+        }
+        CHECK(count == map.size());
+      }
+
+      THEN("keys that are not contained in the map are not found.") {
+        for (size_t i = 0; i < 1000; ++i) {
+          const uint64_t key = rng();
+          CHECK(mapped.contains(key) == map.contains(key));
+        }
+        uint64_t key = 0;
+        while (map.contains(key)) ++key;
+        CHECK(mapped.lookup(key) == mapped.end());
+        CHECK_THROWS_AS(mapped(key), std::invalid_argument);
+      }
+    }
+
+    WHEN("the file is overwritten while it is mapped") {
+      robin_hood::mapped_flat_map<uint64_t, uint64_t> mapped{path};
+      robin_hood::save_mapped(robin_hood::flat_map<uint64_t, uint64_t>{},
+                              path);
+
+      THEN("the old mapping still finds all elements.") {
+        CHECK(mapped.size() == map.size());
+        for (const auto& [key, value] : map)
+          CHECK(mapped(key) == value);
+        CHECK(robin_hood::mapped_flat_map<uint64_t, uint64_t>{path}.empty());
+      }
+    }
+
+    THEN("mapping it with other element types throws.") {
+      CHECK_THROWS_AS((robin_hood::mapped_flat_map<uint32_t, uint64_t>{path}),
+                      std::invalid_argument);
+      CHECK_THROWS_AS((robin_hood::mapped_flat_set<uint64_t>{path}),
+                      std::invalid_argument);
+    }
+  }
+
+  GIVEN("a flat set that has been saved to a file") {
+    robin_hood::flat_set<uint64_t> set{};
+    for (size_t i = 0; i < 1000; ++i)
+      set.insert(rng());
+    robin_hood::save_mapped(set, path);
+
+    THEN("the mapped view contains the same keys.") {
+      robin_hood::mapped_flat_set<uint64_t> mapped{path};
+      CHECK(mapped.size() == set.size());
+      for (const auto& key : set)
+        CHECK(mapped.contains(key));
+      for (const auto& key : mapped)
+        CHECK(set.contains(key));
+    }
+  }
+
+  GIVEN("a flat map with a seeded hasher that has been saved to a file") {
+    using hasher = robin_hood::seeded_hash<uint64_t>;
+    robin_hood::flat_map<uint64_t, uint64_t, hasher> map{};
+    for (size_t i = 0; i < 1000; ++i)
+      map[rng()] = i;
+    robin_hood::save_mapped(map, path);
+
+    THEN("the view uses the stored seed and finds all elements.") {
+      robin_hood::mapped_flat_map<uint64_t, uint64_t, hasher> mapped{path};
+      CHECK(mapped.size() == map.size());
+      for (const auto& [key, value] : map)
+        CHECK(mapped(key) == value);
+    }
+  }
+
+  GIVEN("a file whose header states a size with overflowing offsets") {
+    // All offsets wrap around to the ones of an empty table.
+    using robin_hood::mapped_file_header;
+    const auto header =
+        mapped_file_header::make<uint64_t, uint64_t>(size_t{1} << 61, 0);
+    REQUIRE(header.file_bytes == mapped_file_header::align(sizeof(header)));
+    {
+      ofstream file{path, ios::binary};
+      file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      const vector<char> padding(header.file_bytes - sizeof(header));
+      file.write(padding.data(), padding.size());
+    }
+
+    THEN("mapping it throws.") {
+      CHECK_THROWS_AS((robin_hood::mapped_flat_map<uint64_t, uint64_t>{path}),
+                      std::invalid_argument);
+    }
+  }
+
+  GIVEN("files without a table") {
+    THEN("mapping them throws.") {
+      {
+        ofstream file{path};
+        file << "no table";
+      }
+      CHECK_THROWS_AS((robin_hood::mapped_flat_set<uint64_t>{path}),
+                      std::invalid_argument);
+      filesystem::remove(path);
+      CHECK_THROWS_AS((robin_hood::mapped_flat_set<uint64_t>{path}),
+                      std::system_error);
+    }
+  }
+
+  filesystem::remove(path);
+}
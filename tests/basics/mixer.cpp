@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <cstdint>
+//
+#include <doctest/doctest.h>
+//
+#include <lyrahgames/robin_hood/capacity.hpp>
+#include <lyrahgames/robin_hood/flat_set.hpp>
+#include <lyrahgames/robin_hood/mixer.hpp>
+
+using namespace std;
+using namespace lyrahgames;
+
+namespace {
+
+template <typename Capacity, typename Mixer>
+using set_type = robin_hood::flat_set<uint64_t, hash<uint64_t>,
+                                      equal_to<uint64_t>, allocator<uint64_t>,
+                                      robin_hood::unsynchronized, Capacity,
+                                      Mixer>;
+
+// Inserts keys whose low bits are all zero and returns the maximal PSL.
+template <typename Set>
+auto max_psl_of_structured_keys() {
+  Set set{};
+  for (uint64_t i = 0; i < 1000; ++i)
+    set.insert(i << 20);
+  size_t result = 0;
+  for (uint64_t i = 0; i < 1000; ++i) {
+    const auto [index, psl, found] = set.lookup_data(i << 20);
+    REQUIRE(found);
+    result = max(result, size_t(psl));
+  }
+  return result;
+}
+
+}  // namespace
+
+SCENARIO("robin_hood::flat_set: Mixing Hash Values of Weak Hashers") {
+  using robin_hood::fibonacci_mixer;
+  using robin_hood::fmix64_mixer;
+  using robin_hood::identity_mixer;
+  using power_of_two = robin_hood::power_of_two_capacity;
+  using arbitrary    = robin_hood::arbitrary_capacity<>;
+
+  static_assert(power_of_two::high_index(~size_t{0}, 1) == 0);
+  static_assert(power_of_two::high_index(~size_t{0}, 8) == 7);
+  static_assert(power_of_two::high_index(size_t{1} << 63, 16) == 8);
+
+  GIVEN("keys which only differ in their high bits and an identity hash") {
+    THEN("without a mixer, power-of-two tables degenerate to a single "
+         "cluster.") {
+      using identity_set = set_type<power_of_two, identity_mixer>;
+      CHECK(max_psl_of_structured_keys<identity_set>() == 1000);
+    }
+
+    THEN("with a mixer, probe sequences stay short.") {
+      using fibonacci_set = set_type<power_of_two, fibonacci_mixer>;
+      using fmix64_set    = set_type<power_of_two, fmix64_mixer>;
+      using arbitrary_fibonacci_set = set_type<arbitrary, fibonacci_mixer>;
+      using arbitrary_fmix64_set    = set_type<arbitrary, fmix64_mixer>;
+      CHECK(max_psl_of_structured_keys<fibonacci_set>() < 32);
+      CHECK(max_psl_of_structured_keys<fmix64_set>() < 32);
+      CHECK(max_psl_of_structured_keys<arbitrary_fibonacci_set>() < 32);
+      CHECK(max_psl_of_structured_keys<arbitrary_fmix64_set>() < 32);
+    }
+  }
+}
@@ -0,0 +1,169 @@
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+//
+#include <sys/resource.h>
+//
+#include <doctest/doctest.h>
+//
+#include <lyrahgames/robin_hood/flat_map.hpp>
+#include <lyrahgames/robin_hood/flat_set.hpp>
+#include <lyrahgames/robin_hood/mmap_allocator.hpp>
+
+using namespace std;
+using namespace lyrahgames;
+
+SCENARIO("robin_hood::mmap_allocator: Growing Tables in Place") {
+  using allocator = robin_hood::mmap_allocator<uint64_t>;
+  using map_type  = robin_hood::flat_map<uint64_t, uint64_t, hash<uint64_t>,
+                                        equal_to<uint64_t>, allocator>;
+  static_assert(map_type::base::container::growable_in_place);
+
+  GIVEN("a map of trivially copyable elements with the mmap allocator") {
+    map_type map(8, allocator{});
+
+    WHEN("inserting random elements and triggering many reallocations") {
+      mt19937                           rng{random_device{}()};
+      unordered_map<uint64_t, uint64_t> reference{};
+      for (size_t i = 0; i < 50000; ++i) {
+        const auto key = uint64_t(rng());
+        map.insert_or_assign(key, i);
+        reference[key] = i;
+      }
+
+      THEN("all elements can be found with their values.") {
+        CHECK(map.size() == reference.size());
+        CHECK(map.load_factor() <= map.max_load_factor());
+        for (const auto& [k, v] : reference)
+          CHECK(map(k) == v);
+
+        size_t count = 0;
+        for (const auto& [k, v] : map) {
+          CHECK(reference.at(k) == v);
+          ++count;
+        }
+        CHECK(count == reference.size());
+      }
+    }
+  }
+
+  GIVEN("a set with the mmap allocator and clustered keys") {
+    robin_hood::flat_set<int, hash<int>, equal_to<int>,
+                         robin_hood::mmap_allocator<int>>
+        set{};
+    for (int i = 0; i < 20000; ++i)
+      set.insert(i);
+
+    THEN("all keys survive the in-place rehashes.") {
+      CHECK(set.size() == 20000);
+      for (int i = 0; i < 20000; ++i)
+        CHECK(set.contains(i));
+      CHECK(!set.contains(20000));
+    }
+  }
+
+  GIVEN("a map with non-trivial values and the mmap allocator") {
+    robin_hood::flat_map<int, string, hash<int>, equal_to<int>,
+                         robin_hood::mmap_allocator<int>>
+        map{};
+
+    THEN("the usual rehash with a second table is used.") {
+      for (int i = 0; i < 1000; ++i)
+        map.insert(i, to_string(i));
+      for (int i = 0; i < 1000; ++i)
+        CHECK(map(i) == to_string(i));
+    }
+  }
+}
+
+SCENARIO("robin_hood::mmap_allocator: Overflowing Sizes") {
+  GIVEN("an mmap allocator and a count whose byte count overflows") {
+    robin_hood::mmap_allocator<uint64_t> allocator{};
+    const auto n = size_t(-1) / sizeof(uint64_t) + 1;
+
+    THEN("allocations and reallocations of this count are rejected.") {
+      CHECK_THROWS_AS(allocator.allocate(n), bad_array_new_length);
+      const auto p = allocator.allocate(1);
+      CHECK_THROWS_AS(allocator.reallocate(p, 1, n), bad_array_new_length);
+      allocator.deallocate(p, 1);
+    }
+  }
+}
+
+SCENARIO("robin_hood::mmap_allocator: Growing Without Touching New Pages") {
+  using allocator = robin_hood::mmap_allocator<uint64_t>;
+  using map_type  = robin_hood::flat_map<uint64_t, uint64_t, hash<uint64_t>,
+                                        equal_to<uint64_t>, allocator>;
+  constexpr size_t n     = 1 << 24;
+  constexpr size_t pages = n / 4096;
+
+  const auto minor_faults = [] {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt;
+  };
+
+  GIVEN("a small map with the mmap allocator") {
+    map_type map(8, allocator{});
+    for (uint64_t i = 0; i < 4; ++i)
+      map.insert(i, i);
+
+    WHEN("growing it to a huge capacity in place") {
+      const auto before = minor_faults();
+      map.reserve(n);
+      const auto faults = minor_faults() - before;
+
+      THEN("the zeroed PSLs of new slots are not filled.") {
+        CHECK(map.capacity() >= n);
+        CHECK(size_t(faults) < pages / 2);
+        for (uint64_t i = 0; i < 4; ++i)
+          CHECK(map(i) == i);
+      }
+    }
+  }
+}
+
+SCENARIO("robin_hood::flat_map::prefault: Mapping Pages Ahead of Time") {
+  namespace execution = robin_hood::execution;
+  using allocator = robin_hood::mmap_allocator<uint64_t>;
+  using map_type  = robin_hood::flat_map<uint64_t, uint64_t, hash<uint64_t>,
+                                        equal_to<uint64_t>, allocator>;
+  constexpr size_t n = 1 << 18;
+
+  const auto minor_faults = [] {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt;
+  };
+  const auto faults_of_insertions = [&](map_type& map) {
+    const auto before = minor_faults();
+    for (uint64_t i = 0; i < n; ++i)
+      map.insert(i * 0x9e3779b97f4a7c15ull, i);
+    return minor_faults() - before;
+  };
+
+  GIVEN("a map with reserved but untouched memory") {
+    map_type   map(n, allocator{});
+    const auto faults = faults_of_insertions(map);
+
+    THEN("prefaulted maps do not fault when inserting elements.") {
+      map_type prefaulted(robin_hood::prefaulted, n, {}, {}, allocator{});
+      CHECK(faults_of_insertions(prefaulted) < faults);
+
+      map_type populated(n, allocator{true});
+      CHECK(faults_of_insertions(populated) < faults);
+    }
+
+    WHEN("prefaulting the map after inserting elements") {
+      map.prefault();
+      map.prefault(execution::seq);
+
+      THEN("all elements are kept.") {
+        CHECK(map.size() == n);
+        for (uint64_t i = 0; i < n; ++i)
+          REQUIRE(map(i * 0x9e3779b97f4a7c15ull) == i);
+      }
+    }
+  }
+}
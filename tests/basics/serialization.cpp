@@ -0,0 +1,234 @@
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+//
+#include <doctest/doctest.h>
+//
+#include <lyrahgames/robin_hood/flat_map.hpp>
+#include <lyrahgames/robin_hood/flat_set.hpp>
+#include <lyrahgames/robin_hood/hash.hpp>
+
+using namespace std;
+using namespace lyrahgames;
+
+namespace {
+
+// Custom serializer storing values as decimal text
+// to make sure the given serializers are used.
+struct text_serializer {
+  void write(ostream& os, const int& x) const { os << x << ' '; }
+  auto read(istream& is) const -> int {
+    int x;
+    is >> x;
+    is.get();
+    return x;
+  }
+};
+
+}  // namespace
+
+SCENARIO("robin_hood::flat_map: Binary Serialization") {
+  mt19937 rng{random_device{}()};
+
+  GIVEN("a map with string keys and vector values") {
+    robin_hood::flat_map<string, vector<int>> map{};
+    for (int i = 0; i < 5000; ++i)
+      map[to_string(rng())] = vector<int>(i % 7, i);
+
+    WHEN("it is saved and loaded into another map") {
+      stringstream stream{};
+      map.save(stream);
+      robin_hood::flat_map<string, vector<int>> copy{};
+      copy.insert("old", vector<int>{});
+      copy.load(stream);
+
+      THEN("the table is restored slot by slot.") {
+        CHECK(copy.size() == map.size());
+        CHECK(copy.capacity() == map.capacity());
+        CHECK(copy.max_load_factor() == map.max_load_factor());
+        CHECK(!copy.contains("old"));
+        for (size_t i = 0; i < map.capacity(); ++i) {
+          REQUIRE(copy.data().psl(i) == map.data().psl(i));
+          if (map.data().empty(i)) continue;
+          CHECK(copy.data().key(i) == map.data().key(i));
+          CHECK(copy.data().value(i) == map.data().value(i));
+        }
+        for (const auto& [key, value] : map)
+          CHECK(copy(key) == value);
+      }
+
+      THEN("the loaded map can be modified as usual.") {
+        const auto key = (*map.begin()).first;
+        copy.remove(key);
+        CHECK(!copy.contains(key));
+        copy.insert("new", vector<int>{1, 2, 3});
+        CHECK(copy("new").size() == 3);
+      }
+    }
+
+    WHEN("the stream is truncated") {
+      stringstream stream{};
+      map.save(stream);
+      auto bytes = stream.str();
+      bytes.resize(bytes.size() / 2);
+      stringstream truncated{bytes};
+      robin_hood::flat_map<string, vector<int>> copy{};
+      copy.insert("old", vector<int>{});
+
+      THEN("loading throws and the map is unchanged.") {
+        CHECK_THROWS_AS(copy.load(truncated), std::invalid_argument);
+        CHECK(copy.size() == 1);
+        CHECK(copy.contains("old"));
+      }
+    }
+  }
+
+  GIVEN("a map with seeded hasher and custom value serializer") {
+    using hasher = robin_hood::seeded_hash<uint64_t>;
+    robin_hood::flat_map<uint64_t, int, hasher> map{};
+    for (int i = 0; i < 1000; ++i)
+      map[rng()] = i;
+
+    THEN("loading restores the seed of the hasher.") {
+      stringstream stream{};
+      map.save(stream, robin_hood::serializer<uint64_t>{}, text_serializer{});
+      robin_hood::flat_map<uint64_t, int, hasher> copy{};
+      copy.load(stream, robin_hood::serializer<uint64_t>{}, text_serializer{});
+      CHECK(copy.size() == map.size());
+      for (const auto& [key, value] : map)
+        CHECK(copy(key) == value);
+    }
+  }
+
+  GIVEN("a saved set of strings whose header and data are corrupted") {
+    robin_hood::flat_set<string> set{};
+    set.insert("key");
+    stringstream stream{};
+    set.save(stream);
+    const auto bytes = stream.str();
+    robin_hood::serialization_header header{};
+    memcpy(&header, bytes.data(), sizeof(header));
+
+    const auto corrupted = [&](size_t offset, auto value) {
+      auto result = bytes;
+      memcpy(result.data() + offset, &value, sizeof(value));
+      return result;
+    };
+    const auto fails = [](const string& data) {
+      stringstream in{data};
+      robin_hood::flat_set<string> copy{};
+      copy.insert("old");
+      bool invalid = false;
+      try {
+        copy.load(in);
+      } catch (const std::invalid_argument&) {
+        invalid = true;
+      }
+      return invalid && (copy.size() == 1) && copy.contains("old");
+    };
+    using robin_hood::serialization_header;
+
+    THEN("invalid load factors are rejected.") {
+      const auto max_ratio = offsetof(serialization_header, max_load_ratio);
+      const auto min_ratio = offsetof(serialization_header, min_load_ratio);
+      CHECK(fails(corrupted(max_ratio, 0.0)));
+      CHECK(fails(corrupted(max_ratio, 1.0)));
+      CHECK(fails(corrupted(max_ratio, std::nan(""))));
+      CHECK(fails(corrupted(min_ratio, 0.5)));
+      CHECK(fails(corrupted(min_ratio, -1.0)));
+    }
+
+    THEN("PSLs beyond the stored PSL limit are rejected.") {
+      robin_hood::flat_set<string> other{};
+      for (int i = 0; other.max_psl() < 2; ++i)
+        other.insert(to_string(i));
+      stringstream out{};
+      other.save(out);
+      auto data = out.str();
+      const uint64_t limit = 1;
+      memcpy(data.data() + offsetof(serialization_header, psl_bound), &limit,
+             sizeof(limit));
+      CHECK(fails(data));
+    }
+
+    THEN("full and overloaded tables are rejected.") {
+      auto full      = header;
+      full.load      = full.size;
+      full.psl_bytes = 1;
+      stringstream out{};
+      out.write(reinterpret_cast<const char*>(&full), sizeof(full));
+      for (size_t i = 0; i < full.size; ++i)
+        out.put(1);
+      const robin_hood::serializer<string> serializer{};
+      for (size_t i = 0; i < full.size; ++i)
+        serializer.write(out, to_string(i));
+      CHECK(fails(out.str()));
+
+      const auto load = offsetof(serialization_header, load);
+      CHECK(fails(corrupted(load, header.size - 1)));
+    }
+
+    THEN("PSLs growing by more than one from slot to slot are rejected.") {
+      robin_hood::flat_set<string> other{};
+      for (int i = 0; i < 1000; ++i)
+        other.insert(to_string(i));
+      stringstream out{};
+      other.save(out);
+      auto                 data = out.str();
+      serialization_header h{};
+      memcpy(&h, data.data(), sizeof(h));
+      REQUIRE(h.psl_bytes == 1);
+      // The last occupied slot is not among the slots checked by 'placed'.
+      const auto psls = reinterpret_cast<uint8_t*>(data.data() + sizeof(h));
+      auto       i    = h.size - 1;
+      while (!psls[i])
+        --i;
+      psls[i] = psls[i - 1] + 2;
+      CHECK(fails(data));
+    }
+
+    THEN("huge table sizes are rejected without allocating them.") {
+      const auto size = offsetof(serialization_header, size);
+      CHECK(fails(corrupted(size, uint64_t{1} << 40)));
+      CHECK(fails(corrupted(size, uint64_t{1} << 63)));
+    }
+
+    THEN("huge string lengths are rejected without allocating them.") {
+      const auto key = sizeof(header) + header.size * header.psl_bytes;
+      CHECK(fails(corrupted(key, uint64_t{1} << 60)));
+      CHECK(fails(corrupted(key, ~uint64_t{0})));
+    }
+  }
+
+  GIVEN("a set saved with one hash function") {
+    robin_hood::flat_set<uint64_t, robin_hood::hash<uint64_t>> set{};
+    for (int i = 0; i < 1000; ++i)
+      set.insert(rng());
+    stringstream stream{};
+    set.save(stream);
+
+    THEN("loading it into a set with another hash function throws.") {
+      robin_hood::flat_set<uint64_t> copy{};
+      CHECK_THROWS_AS(copy.load(stream), std::invalid_argument);
+    }
+
+    THEN("loading it into a map throws.") {
+      robin_hood::flat_map<uint64_t, uint64_t> copy{};
+      CHECK_THROWS_AS(copy.load(stream), std::invalid_argument);
+    }
+
+    THEN("loading it into a set of the same type restores all keys.") {
+      robin_hood::flat_set<uint64_t, robin_hood::hash<uint64_t>> copy{};
+      copy.load(stream);
+      CHECK(copy.size() == set.size());
+      for (const auto& key : set)
+        CHECK(copy.contains(key));
+    }
+  }
+}
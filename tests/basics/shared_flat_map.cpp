@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+//
+#include <sys/wait.h>
+#include <unistd.h>
+//
+#include <doctest/doctest.h>
+//
+#include <lyrahgames/robin_hood/hash.hpp>
+#include <lyrahgames/robin_hood/shared_flat_map.hpp>
+
+using namespace std;
+using namespace lyrahgames;
+
+SCENARIO("robin_hood::shared_flat_map: Sharing Tables Between Processes") {
+  using map_type = robin_hood::shared_flat_map<uint64_t, uint64_t>;
+  const auto name = "/robin_hood_shared_flat_map_test_" + to_string(getpid());
+  mt19937    rng{random_device{}()};
+
+  GIVEN("a shared map created by a writer") {
+    auto writer = map_type::create(name, 10000);
+    CHECK(writer.writable());
+    CHECK(writer.empty());
+    CHECK(writer.max_size() >= 10000);
+
+    unordered_map<uint64_t, uint64_t> elements{};
+    while (elements.size() < 10000) {
+      const uint64_t key = rng();
+      elements[key]      = rng();
+      writer.insert_or_assign(key, elements[key]);
+    }
+    CHECK(writer.size() == elements.size());
+
+    WHEN("a reader opens it") {
+      auto reader = map_type::open(name);
+
+      THEN("it finds all elements without being able to modify them.") {
+        CHECK(!reader.writable());
+        CHECK(reader.size() == elements.size());
+        CHECK(reader.capacity() == writer.capacity());
+        for (const auto& [key, value] : elements)
+          CHECK(reader(key) == value);
+        CHECK_THROWS_AS(reader.insert(1, 1), std::invalid_argument);
+      }
+
+      THEN("modifications of the writer are visible to the reader.") {
+        auto it = elements.begin();
+        writer.remove(it->first);
+        CHECK(!reader.contains(it->first));
+        ++it;
+        writer.assign(it->first, 7);
+        CHECK(reader(it->first) == 7);
+        CHECK(reader.size() == elements.size() - 1);
+        writer.clear();
+        CHECK(reader.empty());
+        CHECK(!reader.lookup(it->first));
+      }
+
+      THEN("other processes find the same elements.") {
+        const auto pid = fork();
+        if (pid == 0) {
+          auto child = map_type::open(name);
+          bool valid = child.size() == elements.size();
+          for (const auto& [key, value] : elements)
+            valid = valid && (child.lookup(key) == value);
+          _exit(valid ? 0 : 1);
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+        CHECK(WIFEXITED(status));
+        CHECK(WEXITSTATUS(status) == 0);
+      }
+    }
+
+    THEN("further insertions beyond its capacity throw.") {
+      while (writer.size() < writer.max_size())
+        writer.try_insert(rng(), 0);
+      uint64_t key = 0;
+      while (writer.contains(key)) ++key;
+      CHECK_THROWS_AS(writer.insert(key, 0), std::overflow_error);
+      CHECK_THROWS_AS(writer.insert(elements.begin()->first, 0),
+                      std::invalid_argument);
+    }
+
+    WHEN("the writer dies during a write") {
+      using header = robin_hood::detail::shared_table_header;
+      auto reader  = map_type::open(name);
+      auto memory  = robin_hood::shared_memory::open(name, true);
+      reinterpret_cast<header*>(memory.data())->sequence.fetch_add(1);
+
+      THEN("readers throw instead of waiting forever.") {
+        CHECK_THROWS_AS(reader.contains(elements.begin()->first),
+                        std::runtime_error);
+        CHECK_THROWS_AS(map_type::open(name), std::runtime_error);
+      }
+    }
+
+    WHEN("the header states a size with overflowing offsets") {
+      // All offsets wrap around to the ones of an empty table.
+      using header = robin_hood::detail::shared_table_header;
+      auto  memory = robin_hood::shared_memory::open(name, true);
+      auto& info   = *reinterpret_cast<header*>(memory.data());
+      info.init<uint64_t, uint64_t>(size_t{1} << 61, info.max_load, 0);
+      REQUIRE(info.bytes <= memory.size());
+      // Without occupied slots, the reader would search the whole table.
+      fill(memory.data() + info.psl_offset, memory.data() + memory.size(),
+           byte{0});
+
+      THEN("readers reject it.") {
+        CHECK_THROWS_AS(map_type::open(name), std::invalid_argument);
+      }
+    }
+
+    THEN("creating it for too many elements throws.") {
+      CHECK_THROWS_AS(map_type::create(name + "_huge", size_t(-1) / 2),
+                      std::length_error);
+    }
+
+    THEN("opening it with other types throws.") {
+      using other_type = robin_hood::shared_flat_map<uint64_t, uint32_t>;
+      CHECK_THROWS_AS(other_type::open(name), std::invalid_argument);
+    }
+
+    map_type::unlink(name);
+  }
+
+  GIVEN("a shared map in a file with a seeded hasher") {
+    using seeded_type =
+        robin_hood::shared_flat_map<uint64_t, uint64_t,
+                                    robin_hood::seeded_hash<uint64_t>>;
+    const auto path = filesystem::temp_directory_path() /
+                      ("robin_hood_shared_flat_map_" + to_string(getpid()));
+    auto writer = seeded_type::create_file(path, 100);
+    for (uint64_t i = 0; i < 100; ++i)
+      writer.insert(i, i * i);
+
+    THEN("readers use the same seed.") {
+      auto reader = seeded_type::open_file(path);
+      for (uint64_t i = 0; i < 100; ++i)
+        CHECK(reader(i) == i * i);
+    }
+
+    filesystem::remove(path);
+  }
+
+  GIVEN("a name without shared map") {
+    THEN("opening it throws.") {
+      CHECK_THROWS_AS(map_type::open(name), std::system_error);
+    }
+  }
+}
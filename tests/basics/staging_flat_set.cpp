@@ -0,0 +1,115 @@
+#include <memory>
+#include <new>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+//
+#include <doctest/doctest.h>
+//
+#include <lyrahgames/robin_hood/staging_flat_set.hpp>
+
+using namespace std;
+using namespace lyrahgames;
+
+namespace {
+
+// Allocator whose allocations fail as long as the flag is set.
+template <typename T>
+struct failing_allocator {
+  using value_type = T;
+
+  static inline bool failing = false;
+
+  failing_allocator() noexcept = default;
+
+  template <typename U>
+  constexpr failing_allocator(const failing_allocator<U>&) noexcept {}
+
+  auto allocate(size_t n) -> T* {
+    if (failing) throw bad_alloc{};
+    return allocator<T>{}.allocate(n);
+  }
+
+  void deallocate(T* p, size_t n) noexcept { allocator<T>{}.deallocate(p, n); }
+
+  template <typename U>
+  constexpr bool operator==(const failing_allocator<U>&) const noexcept {
+    return true;
+  }
+};
+
+}  // namespace
+
+SCENARIO("robin_hood::staging_flat_set: Concurrent Deduplication") {
+  GIVEN("a staging set with a small merge threshold") {
+    robin_hood::staging_flat_set<int> set{64};
+    CHECK(set.merge_threshold() == 64);
+    CHECK(set.size() == 0);
+
+    WHEN("multiple threads stage overlapping streams of keys") {
+      constexpr int  n       = 20000;
+      constexpr int  threads = 4;
+      vector<thread> producers{};
+      for (int t = 0; t < threads; ++t)
+        producers.emplace_back([&set, t] {
+          auto stage = set.stage();
+          for (int i = 0; i < n; ++i)
+            stage.insert((i * (t + 1)) % n);
+        });
+      for (auto& producer : producers)
+        producer.join();
+
+      THEN("every distinct key has been merged exactly once.") {
+        unordered_set<int> reference{};
+        for (int t = 0; t < threads; ++t)
+          for (int i = 0; i < n; ++i)
+            reference.insert((i * (t + 1)) % n);
+
+        CHECK(set.size() == reference.size());
+        for (auto k : reference)
+          CHECK(set.contains(k));
+
+        const auto result = set.release();
+        CHECK(result.size() == reference.size());
+        CHECK(set.size() == 0);
+      }
+    }
+
+    WHEN("staging fewer keys than the merge threshold") {
+      auto stage = set.stage();
+      for (int i = 0; i < 10; ++i)
+        stage.insert(i);
+
+      THEN("they are only visible after flushing.") {
+        CHECK(stage.size() == 10);
+        CHECK(set.size() == 0);
+        stage.flush();
+        CHECK(stage.size() == 0);
+        CHECK(set.size() == 10);
+      }
+    }
+  }
+  GIVEN("a staging set whose allocations may fail") {
+    using allocator_type = failing_allocator<int>;
+    robin_hood::staging_flat_set<int, hash<int>, equal_to<int>, allocator_type>
+        set{64};
+
+    WHEN("flushing a stage while allocations fail") {
+      auto stage = set.stage();
+      for (int i = 0; i < 60; ++i)
+        stage.insert(i);
+      for (int i = 60; i < 120; ++i)
+        set.stage().insert(i);
+      allocator_type::failing = true;
+
+      THEN("the failure is reported and the keys stay staged.") {
+        CHECK_THROWS_AS(stage.flush(), bad_alloc);
+        CHECK(stage.size() == 60);
+        allocator_type::failing = false;
+        stage.flush();
+        CHECK(set.size() == 120);
+      }
+      allocator_type::failing = false;
+    }
+  }
+}
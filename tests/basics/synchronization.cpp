@@ -0,0 +1,122 @@
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+//
+#include <doctest/doctest.h>
+//
+#include <lyrahgames/robin_hood/flat_map.hpp>
+#include <lyrahgames/robin_hood/flat_set.hpp>
+#include <lyrahgames/robin_hood/synchronization.hpp>
+
+using namespace std;
+using namespace lyrahgames;
+
+SCENARIO("robin_hood::flat_map: Optimistic Reads with a Seqlock") {
+  using map_type = robin_hood::flat_map<uint64_t, uint64_t, hash<uint64_t>,
+                                        equal_to<uint64_t>,
+                                        allocator<uint64_t>, robin_hood::seqlock>;
+  const auto value = [](uint64_t key) { return 3 * key + 1; };
+
+  GIVEN("an empty map") {
+    map_type map{};
+
+    CHECK(!map.optimistic_contains(1));
+    CHECK(!map.optimistic_lookup(1));
+
+    WHEN("a single writer inserts, assigns, and removes elements while "
+         "multiple readers look them up concurrently") {
+      constexpr uint64_t n = 20000;
+      atomic<bool>       done{false};
+      atomic<size_t>     hits{0};
+      atomic<size_t>     errors{0};
+
+      vector<thread> readers{};
+      for (size_t t = 0; t < 3; ++t)
+        readers.emplace_back([&, t] {
+          uint64_t key = t;
+          while (!done.load(memory_order_acquire)) {
+            key = (key + 7) % n;
+            const auto v = map.optimistic_lookup(key);
+            if (!v) continue;
+            ++hits;
+            if (*v != value(key)) ++errors;
+          }
+        });
+
+      for (uint64_t i = 0; i < n; ++i) {
+        map.insert(i, value(i));
+        if (i % 3 == 0) map.assign(i / 2, value(i / 2));
+        if (i % 5 == 0) map.try_remove(i / 4);
+      }
+      done.store(true, memory_order_release);
+      for (auto& reader : readers)
+        reader.join();
+
+      THEN("readers never observe torn or mismatched values.") {
+        CHECK(errors == 0);
+        for (uint64_t i = 0; i < n; ++i) {
+          REQUIRE(map.optimistic_contains(i) == map.contains(i));
+          if (map.contains(i)) CHECK(*map.optimistic_lookup(i) == value(i));
+        }
+        map.reclaim();
+      }
+    }
+  }
+}
+
+SCENARIO("robin_hood::flat_set: Optimistic Reads with a Seqlock") {
+  GIVEN("a set with the seqlock policy") {
+    robin_hood::flat_set<int, hash<int>, equal_to<int>, allocator<int>,
+                         robin_hood::seqlock>
+        set{};
+
+    WHEN("inserting elements and forcing reallocations") {
+      for (int i = 0; i < 1000; ++i)
+        set.insert(i);
+
+      THEN("the elements are found optimistically and old tables can be "
+           "reclaimed.") {
+        for (int i = 0; i < 1000; ++i)
+          CHECK(set.optimistic_contains(i));
+        CHECK(!set.optimistic_contains(1000));
+        set.reclaim();
+        CHECK(set.optimistic_contains(0));
+      }
+    }
+  }
+}
+
+SCENARIO("robin_hood::flat_set: Asynchronous Disposal with a Seqlock") {
+  GIVEN("a set with the seqlock policy and a concurrent reader") {
+    robin_hood::flat_set<uint64_t, hash<uint64_t>, equal_to<uint64_t>,
+                         allocator<uint64_t>, robin_hood::seqlock>
+        set{};
+    for (uint64_t i = 0; i < 10000; ++i)
+      set.insert(i);
+
+    atomic<bool>   done{false};
+    atomic<size_t> hits{0};
+    thread         reader{[&] {
+      for (uint64_t key = 0; !done.load(memory_order_acquire); ++key)
+        hits += set.optimistic_contains(key % 10000);
+    }};
+
+    WHEN("disposing the table repeatedly while the reader is active") {
+      for (int round = 0; round < 10; ++round) {
+        set.dispose_async().wait();
+        for (uint64_t i = 0; i < 1000; ++i)
+          set.insert(i);
+      }
+      done.store(true, memory_order_release);
+      reader.join();
+
+      THEN("old tables stay alive for the reader until they are reclaimed.") {
+        CHECK(set.size() == 1000);
+        set.reclaim();
+        CHECK(set.optimistic_contains(999));
+        CHECK(!set.optimistic_contains(1000));
+      }
+    }
+  }
+}
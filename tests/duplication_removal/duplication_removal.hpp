@@ -1,4 +1,5 @@
 #pragma once
+#include <memory>
 #include <ranges>
 #include <vector>
 //
@@ -65,15 +66,19 @@ inline auto duplication_count(const T& data) {
   return ranges::size(data) - map.size();
 }
 
-template <std::ranges::input_range T>
+template <template <typename> typename Allocator = std::allocator,
+          std::ranges::input_range T>
 inline auto duplication_removal(const T& data) {
   using namespace std;
+  using namespace lyrahgames;
   using value_type = ranges::range_value_t<T>;
 
   vector<value_type> result{};
   result.reserve(ranges::size(data));
 
-  unordered_map<value_type, int> map{};
+  unordered_map<value_type, int, hash<value_type>, equal_to<value_type>,
+                Allocator<pair<const value_type, int>>>
+      map{};
   map.rehash(ranges::size(data));
   for (const auto& p : data)
     ++map[p];
@@ -100,7 +105,8 @@ inline auto duplication_count(const T& data) {
   return ranges::size(data) - map.size();
 }
 
-template <std::ranges::input_range T>
+template <template <typename> typename Allocator = std::allocator,
+          std::ranges::input_range T>
 inline auto duplication_removal(const T& data) {
   using namespace std;
   using namespace lyrahgames;
@@ -109,7 +115,9 @@ inline auto duplication_removal(const T& data) {
   vector<value_type> result{};
   result.reserve(ranges::size(data));
 
-  robin_hood::map<value_type, int> map{};
+  robin_hood::map<value_type, int, hash<value_type>, equal_to<value_type>,
+                  Allocator<value_type>>
+      map{};
   map.reserve(ranges::size(data));
   for (const auto& p : data)
     ++map[p];
@@ -133,7 +141,8 @@ inline auto duplication_count(const T& data) {
   return ranges::size(data) - set.size();
 }
 
-template <std::ranges::input_range T>
+template <template <typename> typename Allocator = std::allocator,
+          std::ranges::input_range T>
 inline auto duplication_removal(const T& data) {
   using namespace std;
   using lyrahgames::robin_hood::flat_set;
@@ -143,7 +152,9 @@ inline auto duplication_removal(const T& data) {
   result.reserve(ranges::size(data));
 
   // auto set = robin_hood::auto_flat_set(data);
-  flat_set<value_type> set{};
+  flat_set<value_type, hash<value_type>, equal_to<value_type>,
+           Allocator<value_type>>
+      set{};
   set.insert(data);
 
   for (const auto& p : set)
@@ -169,7 +180,8 @@ inline auto duplication_count(const T& data) {
   return ranges::size(data) - map.size();
 }
 
-template <std::ranges::input_range T>
+template <template <typename> typename Allocator = std::allocator,
+          std::ranges::input_range T>
 inline auto duplication_removal(const T& data) {
   using namespace std;
   using namespace lyrahgames;
@@ -178,7 +190,9 @@ inline auto duplication_removal(const T& data) {
   vector<value_type> result{};
   result.reserve(ranges::size(data));
 
-  robin_hood::flat_map<value_type, int> map{};
+  robin_hood::flat_map<value_type, int, hash<value_type>, equal_to<value_type>,
+                       Allocator<value_type>>
+      map{};
   map.reserve(ranges::size(data));
   for (const auto& p : data) {
     // ++map[p];
@@ -8,6 +8,7 @@
 //
 #include <lyrahgames/xstd/chrono.hpp>
 //
+#include <lyrahgames/robin_hood/counting_allocator.hpp>
 #include <lyrahgames/robin_hood/map.hpp>
 //
 #include "duplication_removal.hpp"
@@ -83,6 +84,10 @@ int main(int argc, char** argv) {
   // Shuffle points.
   shuffle(begin(points), end(points), rng);
 
+  // The timed runs use the standard allocator. Memory is measured in a
+  // separate run with the counting allocator on a copy of the input.
+  const auto input = points;
+
   chrono::duration<double> time{};
 
   switch (method) {
@@ -98,6 +103,9 @@ int main(int argc, char** argv) {
       time = xstd::duration([&points] {
         points = std_unordered_map::duplication_removal(points);
       });
+      robin_hood::allocation_counter::reset();
+      std_unordered_map::duplication_removal<
+          robin_hood::counting_allocator>(input);
       break;
 
     case implementation::lyrahgames_robin_hood_map:
@@ -106,6 +114,9 @@ int main(int argc, char** argv) {
       time = xstd::duration([&points] {
         points = lyrahgames_robin_hood_map::duplication_removal(points);
       });
+      robin_hood::allocation_counter::reset();
+      lyrahgames_robin_hood_map::duplication_removal<
+          robin_hood::counting_allocator>(input);
       break;
 
     case implementation::lyrahgames_robin_hood_flat_set:
@@ -114,6 +125,9 @@ int main(int argc, char** argv) {
       time = xstd::duration([&points] {
         points = lyrahgames_robin_hood_flat_set::duplication_removal(points);
       });
+      robin_hood::allocation_counter::reset();
+      lyrahgames_robin_hood_flat_set::duplication_removal<
+          robin_hood::counting_allocator>(input);
       break;
 
     case implementation::lyrahgames_robin_hood_flat_map:
@@ -122,11 +136,18 @@ int main(int argc, char** argv) {
       time = xstd::duration([&points] {
         points = lyrahgames_robin_hood_flat_map::duplication_removal(points);
       });
+      robin_hood::allocation_counter::reset();
+      lyrahgames_robin_hood_flat_map::duplication_removal<
+          robin_hood::counting_allocator>(input);
       break;
   }
 
   assert(points.size() == unique_point_count);
-  cout << setw(30) << "time = " << setw(15) << time.count() << " s" << '\n';
+  cout << setw(30) << "time = " << setw(15) << time.count() << " s" << '\n'
+       << setw(30) << "peak memory = " << setw(15)
+       << robin_hood::allocation_counter::peak_bytes() << " B" << '\n'
+       << setw(30) << "allocations = " << setw(15)
+       << robin_hood::allocation_counter::allocations() << '\n';
 
   sort(begin(points), end(points));
   assert(points == ref_point_set);
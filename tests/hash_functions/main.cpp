@@ -0,0 +1,83 @@
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+//
+#include <lyrahgames/xstd/chrono.hpp>
+//
+#include <lyrahgames/robin_hood/flat_map.hpp>
+#include <lyrahgames/robin_hood/hash.hpp>
+//
+#include "../duplication_removal/point.hpp"
+
+using namespace std;
+using namespace lyrahgames;
+
+// Inserts the given keys into a flat map with the given hasher and reports the
+// time needed for hashing, insertion, and the lookup of all keys.
+template <typename Hasher, typename Key>
+void benchmark(const string& name, const vector<Key>& keys) {
+  const Hasher hasher{};
+  size_t       checksum  = 0;
+  const auto   hash_time = xstd::duration([&] {
+    for (const auto& key : keys)
+      checksum ^= hasher(key);
+  });
+
+  robin_hood::flat_map<Key, size_t, Hasher> map{};
+  const auto insertion_time = xstd::duration([&] {
+    for (size_t i = 0; i < keys.size(); ++i)
+      map.insert_or_assign(keys[i], i);
+  });
+
+  size_t     count       = 0;
+  const auto lookup_time = xstd::duration([&] {
+    for (size_t i = 0; i < 10; ++i)
+      for (const auto& key : keys)
+        count += map.contains(key);
+  });
+  if (count != 10 * map.size()) cerr << "Lookups failed!\n";
+
+  cout << setw(25) << name << setw(15) << hash_time.count() << setw(15)
+       << insertion_time.count() << setw(15) << lookup_time.count()
+       << setw(22) << checksum << '\n';
+}
+
+void print_header(const string& title, size_t n) {
+  cout << '\n'
+       << title << " (" << n << " keys)\n"
+       << setw(25) << "hasher" << setw(15) << "hash [s]" << setw(15)
+       << "insertion [s]" << setw(15) << "lookup [s]" << setw(22)
+       << "checksum" << '\n';
+}
+
+int main(int argc, char** argv) {
+  size_t n = 1 << 18;
+  if (argc > 1) n = stoi(argv[1]);
+
+  auto rng = mt19937_64{random_device{}()};
+
+  vector<uint64_t> integers(n);
+  for (auto& x : integers)
+    x = rng();
+  print_header("random integers", n);
+  benchmark<std::hash<uint64_t>>("std::hash", integers);
+  benchmark<robin_hood::hash<uint64_t>>("robin_hood::hash", integers);
+
+  vector<string> urls(n);
+  for (size_t i = 0; i < n; ++i)
+    urls[i] = "https://www.example.com/catalog/item?id=" + to_string(rng());
+  print_header("URLs", n);
+  benchmark<std::hash<string>>("std::hash", urls);
+  benchmark<robin_hood::hash<string>>("robin_hood::hash", urls);
+
+  auto          dist = uniform_real_distribution<float>{};
+  vector<point> points(n);
+  for (auto& p : points)
+    p = {dist(rng), dist(rng), dist(rng)};
+  print_header("points", n);
+  benchmark<std::hash<point>>("std::hash", points);
+  benchmark<robin_hood::pod_hash<point>>("robin_hood::pod_hash", points);
+}
@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+//
+#include <lyrahgames/xstd/chrono.hpp>
+//
+#include <lyrahgames/robin_hood/flat_set.hpp>
+#include <lyrahgames/robin_hood/mixer.hpp>
+//
+#include "../duplication_removal/point.hpp"
+
+using namespace std;
+using namespace lyrahgames;
+
+// Inserts the given keys into a set with the given mixer and reports the
+// average and maximal probe sequence length together with the time needed to
+// look up all keys.
+template <typename Mixer, typename Key>
+void benchmark(const string& name, const vector<Key>& keys) {
+  robin_hood::flat_set<Key, hash<Key>, equal_to<Key>, allocator<Key>,
+                       robin_hood::unsynchronized,
+                       robin_hood::power_of_two_capacity, Mixer>
+      set{};
+  const auto insertion_time = xstd::duration([&] {
+    for (const auto& key : keys)
+      set.insert(key);
+  });
+
+  size_t psl_sum = 0;
+  size_t psl_max = 0;
+  for (const auto& key : keys) {
+    const auto [index, psl, found] = set.lookup_data(key);
+    psl_sum += psl;
+    psl_max = max(psl_max, size_t(psl));
+  }
+
+  size_t     count       = 0;
+  const auto lookup_time = xstd::duration([&] {
+    for (size_t i = 0; i < 10; ++i)
+      for (const auto& key : keys)
+        count += set.contains(key);
+  });
+  if (count != 10 * keys.size()) cerr << "Lookups failed!\n";
+
+  cout << setw(20) << name << setw(15) << double(psl_sum) / keys.size()
+       << setw(15) << psl_max << setw(15) << insertion_time.count()
+       << setw(15) << lookup_time.count() << '\n';
+}
+
+template <typename Key>
+void benchmark_all(const string& title, const vector<Key>& keys) {
+  cout << '\n'
+       << title << " (" << keys.size() << " keys)\n"
+       << setw(20) << "mixer" << setw(15) << "mean psl" << setw(15)
+       << "max psl" << setw(15) << "insertion [s]" << setw(15)
+       << "lookup [s]" << '\n';
+  benchmark<robin_hood::identity_mixer>("identity", keys);
+  benchmark<robin_hood::fibonacci_mixer>("fibonacci", keys);
+  benchmark<robin_hood::fmix64_mixer>("fmix64", keys);
+}
+
+int main(int argc, char** argv) {
+  size_t n = 1 << 14;
+  if (argc > 1) n = stoi(argv[1]);
+
+  // Keys whose low bits are constant.
+  vector<uint64_t> strided(n);
+  for (size_t i = 0; i < n; ++i)
+    strided[i] = uint64_t(i) << 16;
+  benchmark_all("strided integers with std::hash", strided);
+
+  // Consecutive keys are the best case of the identity.
+  vector<uint64_t> consecutive(n);
+  for (size_t i = 0; i < n; ++i)
+    consecutive[i] = i;
+  benchmark_all("consecutive integers with std::hash", consecutive);
+
+  // Points of a regular grid with the shift-xor hash of 'point.hpp'.
+  const auto    m = size_t(cbrt(double(n))) + 1;
+  vector<point> grid{};
+  grid.reserve(m * m * m);
+  for (size_t i = 0; i < m; ++i)
+    for (size_t j = 0; j < m; ++j)
+      for (size_t k = 0; k < m; ++k)
+        grid.push_back({float(i), float(j), float(k)});
+  benchmark_all("grid points with std::hash<point>", grid);
+}
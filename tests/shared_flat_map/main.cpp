@@ -0,0 +1,126 @@
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+//
+#include <sys/wait.h>
+#include <unistd.h>
+//
+#include <lyrahgames/xstd/chrono.hpp>
+//
+#include <lyrahgames/robin_hood/flat_map.hpp>
+#include <lyrahgames/robin_hood/shared_flat_map.hpp>
+
+using namespace std;
+using namespace lyrahgames;
+
+// Result of a single reader process which is sent back through a pipe.
+struct result {
+  double time;
+  size_t pss;
+  size_t found;
+};
+
+// Returns the proportional set size of this process in bytes. Pages shared
+// by multiple processes are divided among them.
+size_t proportional_set_size() {
+  ifstream file{"/proc/self/smaps_rollup"};
+  string   line{};
+  while (getline(file, line))
+    if (line.starts_with("Pss:")) return stoull(line.substr(4)) * 1024;
+  return 0;
+}
+
+// Forks the given count of processes which call the given function and sums
+// up their results.
+template <typename F>
+auto run_readers(size_t processes, F&& f) -> result {
+  int channel[2];
+  if (pipe(channel) < 0) throw runtime_error("Failed to create pipe!");
+  size_t started = 0;
+  for (; started < processes; ++started) {
+    const auto pid = fork();
+    if (pid < 0) break;
+    if (pid != 0) continue;
+    close(channel[0]);
+    const auto r = f(started);
+    // Results are smaller than PIPE_BUF and therefore written atomically.
+    const auto written = write(channel[1], &r, sizeof(r));
+    _exit((written == sizeof(r)) ? 0 : 1);
+  }
+  close(channel[1]);
+  result sum{0, 0, 0};
+  size_t received = 0;
+  for (; received < started; ++received) {
+    result r{};
+    if (read(channel[0], &r, sizeof(r)) != sizeof(r)) break;
+    sum.time += r.time / processes;
+    sum.pss += r.pss;
+    sum.found += r.found;
+  }
+  close(channel[0]);
+  bool failed = (started != processes) || (received != processes);
+  int  status = 0;
+  while (wait(&status) > 0)
+    failed = failed || !WIFEXITED(status) || (WEXITSTATUS(status) != 0);
+  if (failed) throw runtime_error("Failed to collect results of readers!");
+  return sum;
+}
+
+void print(const string& name, const result& r) {
+  cout << setw(15) << name << setw(20) << r.time << setw(20)
+       << r.pss / (1024.0 * 1024.0) << setw(15) << r.found << '\n';
+}
+
+int main(int argc, char** argv) {
+  size_t n         = 1 << 22;
+  size_t processes = 4;
+  if (argc > 1) n = stoull(argv[1]);
+  if (argc > 2) processes = stoull(argv[2]);
+
+  mt19937          rng{random_device{}()};
+  vector<uint64_t> keys(n);
+  for (auto& key : keys)
+    key = rng();
+
+  const string name = "/robin_hood_shared_flat_map_benchmark";
+  {
+    auto map = robin_hood::shared_flat_map<uint64_t, uint64_t>::create(name, n);
+    for (size_t i = 0; i < n; ++i)
+      map.insert_or_assign(keys[i], i);
+  }
+
+  cout << n << " elements, " << processes << " reader processes\n"
+       << setw(15) << "table" << setw(20) << "mean lookup [s]" << setw(20)
+       << "sum of PSS [MiB]" << setw(15) << "found" << '\n';
+
+  // Every process maps the same table.
+  print("shared", run_readers(processes, [&](size_t) {
+          const auto map =
+              robin_hood::shared_flat_map<uint64_t, uint64_t>::open(name);
+          size_t     found = 0;
+          const auto time  = xstd::duration([&] {
+            for (const auto& key : keys)
+              found += map.contains(key);
+          });
+          return result{time.count(), proportional_set_size(), found};
+        }));
+
+  // Every process builds its own table.
+  print("private", run_readers(processes, [&](size_t) {
+          robin_hood::flat_map<uint64_t, uint64_t> map{};
+          for (size_t i = 0; i < n; ++i)
+            map.insert_or_assign(keys[i], i);
+          size_t     found = 0;
+          const auto time  = xstd::duration([&] {
+            for (const auto& key : keys)
+              found += map.contains(key);
+          });
+          return result{time.count(), proportional_set_size(), found};
+        }));
+
+  robin_hood::shared_flat_map<uint64_t, uint64_t>::unlink(name);
+}